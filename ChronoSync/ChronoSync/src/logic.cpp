@@ -26,6 +26,7 @@
 #include "logic.hpp"
 #include "logger.hpp"
 #include "bzip2-helper.hpp"
+#include "event-log/event-log.hpp"
 
 #include <ndn-cxx/util/backports.hpp>
 #include <ndn-cxx/util/string-helper.hpp>
@@ -658,8 +659,7 @@ Logic::sendResetInterest()
   interest.setInterestLifetime(m_resetInterestLifetime);
   
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Sync Interest"
-            << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncInterest, 0, 0);
 
   const ndn::PendingInterestId* pendingInterestId = m_face.expressInterest(interest,
     bind(&Logic::onResetData, this, _1, _2),
@@ -709,8 +709,7 @@ Logic::sendSyncInterest()
   }
   
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Sync Interest: "
-            << interestName << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncInterest, 0, 0);
 
   m_outstandingInterestId = m_face.expressInterest(interest,
                                                    bind(&Logic::onSyncData, this, _1, _2),
@@ -787,8 +786,7 @@ Logic::sendSyncData(const Name& nodePrefix, const Name& name, const State& state
     return;
   
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Sync Reply "
-            << name.toUri() << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncReply, 0, 0);
 
   m_face.put(encodeSyncReply(nodePrefix, name, state));
 
@@ -847,8 +845,7 @@ Logic::sendRecoveryInterest(ConstBufferPtr digest)
   interest.setInterestLifetime(m_recoveryInterestLifetime);
   
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Sync Interest (Recovery)"
-            << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncInterest, 0, 0);
 
   const ndn::PendingInterestId* pendingInterestId = m_face.expressInterest(interest,
     bind(&Logic::onRecoveryData, this, _1, _2),
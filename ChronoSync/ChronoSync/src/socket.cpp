@@ -27,6 +27,7 @@
 
 #include "socket.hpp"
 #include "logger.hpp"
+#include "event-log/event-log.hpp"
 #include <time.h>
 
 INIT_LOGGER(Socket);
@@ -148,10 +149,8 @@ Socket::publishData(const Block& content, const ndn::time::milliseconds& freshne
   data->setName(dataName);
   
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-            << dataName << std::endl;
-  std::cout << now << " microseconds node(" << m_nid << ") Store New Data: "
-            << dataName.getSubName(1) << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kStateStore, dataName.toUri());
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kDataStore, dataName.getSubName(1).toUri());
 
   if (m_signingId.empty())
     m_keyChain.sign(*data);
@@ -177,10 +176,8 @@ Socket::publishData(const Block& content, const ndn::time::milliseconds& freshne
   data->setName(dataName);
  
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-            << dataName << std::endl;
-  std::cout << now << " microseconds node(" << m_nid << ") Store New Data: "
-            << dataName.getSubName(1) << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kStateStore, dataName.toUri());
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kDataStore, dataName.getSubName(1).toUri());
  
   if (m_signingId.empty())
     m_keyChain.sign(*data);
@@ -206,8 +203,7 @@ Socket::fetchData(const Name& sessionName, const SeqNo& seqNo,
 
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
   if (!isFwd) {
-    std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-              << interestName << std::endl;
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kStateStore, interestName.toUri());
   }
 
   DataValidationErrorCallback failureCallback =
@@ -218,8 +214,7 @@ Socket::fetchData(const Name& sessionName, const SeqNo& seqNo,
   m_scheduler.scheduleEvent(time::milliseconds(delay), 
                             [this, interest, interestName, dataCallback, failureCallback, nRetries, isFwd] {
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest (" 
-              << (isFwd ? "Forward" : "1") << "): " << interestName << std::endl;
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendDataInterest, interestName.toUri());
     m_face.expressInterest(interest,
                            bind(&Socket::onData, this, _1, _2, dataCallback, failureCallback),
                            bind(&Socket::onDataTimeout, this, _1, nRetries,
@@ -241,8 +236,7 @@ Socket::fetchData(const Name& sessionName, const SeqNo& seqNo,
   interestName.append(sessionName).appendNumber(seqNo);
 
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-            << interestName << std::endl;
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kStateStore, interestName.toUri());
 
   Interest interest(interestName);
   // interest.setMustBeFresh(true);
@@ -252,8 +246,7 @@ Socket::fetchData(const Name& sessionName, const SeqNo& seqNo,
   m_scheduler.scheduleEvent(time::milliseconds(delay), 
                             [this, interest, interestName, dataCallback, failureCallback, onTimeout] {
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest (2): "
-            << interestName << std::endl;
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendDataInterest, interestName.toUri());
     m_face.expressInterest(interest,
                            bind(&Socket::onData, this, _1, _2, dataCallback, failureCallback),
                            bind(onTimeout, _1), // Nack
@@ -278,8 +271,8 @@ Socket::onInterest(const Name& prefix, const Interest& interest)
     int delay = m_data_interest_random();
     m_scheduler.scheduleEvent(time::milliseconds(delay), [this, interest, data]{
       int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-      std::cout << now << " microseconds node(" << m_nid << ") Send Data Reply "
-                << interest.getName().toUri() << std::endl;
+      ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendDataReply,
+                              interest.getName().toUri());
       m_face.put(*data);
     });
   } else if (m_no_data_callback) {
@@ -331,8 +324,8 @@ Socket::onDataTimeout(const Interest& interest, int nRetries,
   m_scheduler.scheduleEvent(time::milliseconds(delay), 
                             [this, newNonceInterest, nRetries, reason, onValidated, onFailed] {
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest (" 
-              << reason << "): " << newNonceInterest.getName().toUri() << std::endl;
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendDataInterest,
+                            newNonceInterest.getName().toUri());
     m_face.expressInterest(newNonceInterest,
                            bind(&Socket::onData, this, _1, _2, onValidated, onFailed),
                            bind(&Socket::onDataTimeout, this, _1, nRetries - 1,
@@ -21,6 +21,8 @@
 
 #include "chronosync.hpp"
 
+#include "event-log/event-log.hpp"
+
 namespace ndn {
 
 ChronoSync::ChronoSync(uint64_t nid, const int minNumberMessages, const int maxNumberMessages)
@@ -71,8 +73,7 @@ ChronoSync::delayedInterest(int id)
   if (now > (int64_t)m_dataGenerationDuration * 1000 * 1000) { 
     return;
   }
-  std::cout << now << " microseconds node(" << m_nid 
-            << ") Publish data with id: " << id << "\n";
+  eventlog::LogEvent(now, m_nid, eventlog::kPublish, m_nid, id);
   m_socket->publishData(reinterpret_cast<const uint8_t*>(std::to_string(id).c_str()),
                         std::to_string(id).size(), ndn::time::milliseconds(4000));
 
@@ -109,8 +110,7 @@ ChronoSync::printData(const Data& data)
   std::lock_guard<std::mutex> guard(m_dataFetchedMutex);
   if (m_dataFetched.find(data_name) == m_dataFetched.end()) {
     m_dataFetched.insert(data_name);
-    std::cout << now << " microseconds node(" << m_nid 
-              << ") Store New Data: " << data_name.toUri() << "\n";
+    eventlog::LogEvent(now, m_nid, eventlog::kDataStore, data_name.toUri());
   }
 }
 
@@ -9,12 +9,13 @@ if [ $# -eq 1 ]; then
     LOSS_RATE=$1
 fi
 
-rm -f results/*.txt
+rm -f results/*.txt results/*.events*
 ./waf
 
 for (( TIME=1; TIME<=$RUN_TIMES; TIME++ )); do
     ./build/chronosync-mobile \
         --lossRate=${LOSS_RATE} \
+        --eventLog=results/result_${TIME}.events \
         >> results/result_${TIME}.txt &
     pids="$pids $!"
 done
@@ -27,6 +27,10 @@
 #include "ns3/mobility-module.h"
 #include <cstdio>
 
+#include "event-log/event-log.hpp"
+#include "unit-disk/unit-disk-helper.hpp"
+#include "mobility/ns3-waypoint-mobility.hpp"
+
 
 namespace ns3 {
 namespace ndn {
@@ -42,10 +46,16 @@ main(int argc, char* argv[])
 
   // Set params
   double loss_rate;
+  std::string event_log;
+  bool unit_disk = false;
   CommandLine cmd;
   cmd.AddValue("lossRate", "loss rate", loss_rate);
+  cmd.AddValue("eventLog", "binary event log file", event_log);
+  cmd.AddValue("unitDisk", "fast mode: unit-disk devices instead of wifi", unit_disk);
 
   cmd.Parse(argc, argv);
+  if (!event_log.empty())
+    ::ndn::eventlog::EventLogWriter::Instance().Open(event_log);
   int node_num = 30;
   int range = 60;
   int sim_time = 2400;
@@ -73,14 +83,21 @@ main(int argc, char* argv[])
   NodeContainer nodes;
   nodes.Create(node_num);
 
-  // 1. Install wifi
-  NetDeviceContainer wifiNetDevices = wifi.Install(wifiPhyHelper, wifiMacHelper, nodes);
-  wifi.AssignStreams(wifiNetDevices, 0);
+  // 1. Install wifi, or unit-disk devices of the same range and rate in fast mode
+  if (unit_disk) {
+    UnitDiskHelper unitDisk;
+    unitDisk.SetChannelAttribute("Range", DoubleValue(range));
+    NetDeviceContainer unitDiskDevices = unitDisk.Install(nodes);
+    unitDisk.AssignStreams(unitDiskDevices, 0);
+  }
+  else {
+    NetDeviceContainer wifiNetDevices = wifi.Install(wifiPhyHelper, wifiMacHelper, nodes);
+    wifi.AssignStreams(wifiNetDevices, 0);
+  }
 
   // 2. Install mobility
   auto traceFile = "trace/scenario-" + to_string(node_num) + ".ns_movements";
-  Ns2MobilityHelper ns2 = Ns2MobilityHelper(traceFile);
-  ns2.Install();
+  InstallMobilityTrace(traceFile);
 
   // 3. Install NDN stack
   StackHelper ndnHelper;
@@ -127,6 +144,8 @@ main(int argc, char* argv[])
 
   Simulator::Stop(Seconds(sim_time));
   
+  /* Drain the event log before the process exits */
+  Simulator::ScheduleDestroy(&::ndn::eventlog::CloseEventLog);
   Simulator::Run();
   Simulator::Destroy();
 
@@ -5,12 +5,18 @@ def variance(lst):
     mean = float(sum(lst)) / len(lst)
     return float(reduce(lambda x, y: x + y, map(lambda x: (x - mean) ** 2, lst))) / len(lst)
 
+def value(result):
+    # Last token of a sync-analyzer line: "key": value, with a comma unless it
+    # is the last key, and null for an undefined value
+    token = result.split()[-1].rstrip(',')
+    return float('nan') if token == 'null' else float(token)
+
 def main(path, filenames):
     files = [open(file, "r") for file in filenames]
     for row in zip(*files):
         if '=' in row[0]:
             condition = ' '.join(row[0].split()[:-1])
-            results = [float(result.split()[-1]) for result in row]
+            results = [value(result) for result in row]
             print(condition + " " + str(sum(results) / len(results)) + " variance: " + str(variance(results)))
         else:
             print row[0].strip()
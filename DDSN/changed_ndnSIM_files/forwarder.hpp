@@ -199,6 +199,27 @@ public: // allow enabling ndnSIM content store (will be removed in the future)
     m_id = nodeID;
   }
 
+  /** \brief packets sent and cache hits so far, for periodic sampling
+   */
+  struct TrafficCounters
+  {
+    uint64_t outData;
+    uint64_t outAck;
+    uint64_t outBundledData;
+    uint64_t outNotifyInterest;
+    uint64_t outBeacon;
+    uint64_t outBundledInterest;
+    uint64_t outDataInterest;
+    uint64_t cacheHit;
+    uint64_t cacheHitSpecial;
+  };
+
+  TrafficCounters
+  getTrafficCounters() const {
+    return {m_outData, m_outAck, m_outBundledData, m_outNotifyInterest, m_outBeacon,
+            m_outBundledInterest, m_outDataInterest, m_cacheHit, m_cacheHitSpecial};
+  }
+
   void
   setLossRate(double loss_rate) {
     std::cout << "set m_loss_rate as " << loss_rate << std::endl; 
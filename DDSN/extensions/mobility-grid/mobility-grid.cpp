@@ -0,0 +1,56 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "mobility-grid.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+MobilityGrid::MobilityGrid(double cell_size)
+  : grid_(cell_size)
+{
+}
+
+void
+MobilityGrid::Add(const NodeContainer& nodes)
+{
+  for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); ++i)
+    Add(*i);
+}
+
+void
+MobilityGrid::Add(Ptr<Node> node)
+{
+  Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
+  NS_ASSERT_MSG(mobility, "Node " << node->GetId() << " has no MobilityModel");
+  if (node->GetId() >= nodes_.size())
+    nodes_.resize(node->GetId() + 1);
+  nodes_[node->GetId()] = node;
+  Update(mobility, node->GetId());
+  mobility->TraceConnectWithoutContext("CourseChange",
+                                       MakeCallback(&MobilityGrid::OnCourseChange, this));
+}
+
+size_t
+MobilityGrid::CountWithin(Ptr<Node> node, double range)
+{
+  Vector pos = node->GetObject<MobilityModel>()->GetPosition();
+  return grid_.CountWithin(Simulator::Now().GetSeconds(), pos.x, pos.y, pos.z, range,
+                           node->GetId());
+}
+
+void
+MobilityGrid::OnCourseChange(Ptr<const MobilityModel> mobility)
+{
+  Update(mobility, mobility->GetObject<Node>()->GetId());
+}
+
+void
+MobilityGrid::Update(Ptr<const MobilityModel> mobility, uint32_t id)
+{
+  Vector pos = mobility->GetPosition();
+  Vector vel = mobility->GetVelocity();
+  grid_.Update(id, Simulator::Now().GetSeconds(), pos.x, pos.y, pos.z, vel.x, vel.y, vel.z);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#pragma once
+
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/ptr.h"
+#include "ns3/simulator.h"
+
+#include <vector>
+
+#include "spatial/spatial-grid.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Spatial index over the MobilityModels of a set of nodes, shared by
+ *        the apps that need to know who is within range.
+ *
+ * Follows every node through the CourseChange trace of its MobilityModel,
+ * see spatial/spatial-grid.hpp. Nodes are identified by their ns-3 node id.
+ * Must outlive the simulation.
+ */
+class MobilityGrid
+{
+public:
+  /**
+   * @param cell_size Grid cell size in meters, best about the query range
+   */
+  explicit
+  MobilityGrid(double cell_size);
+
+  /**
+   * @brief Index @p nodes, which must already have a MobilityModel.
+   */
+  void
+  Add(const NodeContainer& nodes);
+
+  void
+  Add(Ptr<Node> node);
+
+  bool
+  Contains(Ptr<Node> node) const
+  {
+    return node->GetId() < nodes_.size() && nodes_[node->GetId()] != 0;
+  }
+
+  /**
+   * @brief Number of other indexed nodes within @p range of @p node now.
+   */
+  size_t
+  CountWithin(Ptr<Node> node, double range);
+
+  /**
+   * @brief Call f(Ptr<Node>) for every other indexed node within @p range
+   *        of @p node now.
+   */
+  template <typename F>
+  void
+  ForEachWithin(Ptr<Node> node, double range, F f);
+
+  const ::ndn::spatial::SpatialGrid&
+  GetGrid() const
+  {
+    return grid_;
+  }
+
+private:
+  void
+  OnCourseChange(Ptr<const MobilityModel> mobility);
+
+  void
+  Update(Ptr<const MobilityModel> mobility, uint32_t id);
+
+  ::ndn::spatial::SpatialGrid grid_;
+  std::vector<Ptr<Node>> nodes_;      /* By node id */
+};
+
+template <typename F>
+void
+MobilityGrid::ForEachWithin(Ptr<Node> node, double range, F f)
+{
+  Vector pos = node->GetObject<MobilityModel>()->GetPosition();
+  uint32_t self = node->GetId();
+  grid_.ForEachWithin(Simulator::Now().GetSeconds(), pos.x, pos.y, pos.z, range,
+                      [this, self, &f] (::ndn::spatial::SpatialGrid::Id id) {
+                        if (id != self)
+                          f(nodes_[id]);
+                      });
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "range-culled-wifi-channel.hpp"
+
+#include "ns3/double.h"
+#include "ns3/net-device.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(RangeCulledWifiChannel);
+
+TypeId
+RangeCulledWifiChannel::GetTypeId()
+{
+  static TypeId tid = TypeId("RangeCulledWifiChannel")
+    .SetParent<YansWifiChannel>()
+    .AddConstructor<RangeCulledWifiChannel>()
+    .AddAttribute("MaxRange", "Deliver to PHYs within this distance (m) of the sender",
+                  DoubleValue(250),
+                  MakeDoubleAccessor(&RangeCulledWifiChannel::m_maxRange),
+                  MakeDoubleChecker<double>(0))
+    .AddAttribute("Guard", "Margin (m) added to MaxRange",
+                  DoubleValue(1),
+                  MakeDoubleAccessor(&RangeCulledWifiChannel::m_guard),
+                  MakeDoubleChecker<double>(0));
+  return tid;
+}
+
+RangeCulledWifiChannel::RangeCulledWifiChannel()
+  : m_grid(nullptr)
+  , m_indexedPhys(0)
+{
+}
+
+void
+RangeCulledWifiChannel::GetReceivers(Ptr<YansWifiPhy> sender,
+                                     std::vector<uint32_t>& receivers) const
+{
+  if (m_grid == nullptr) {
+    YansWifiChannel::GetReceivers(sender, receivers);
+    return;
+  }
+  if (m_indexedPhys != GetNDevices())
+    IndexPhys();
+
+  /* The sender's node too, in case it has other PHYs on this channel */
+  Ptr<Node> node = sender->GetMobility()->GetObject<Node>();
+  receivers = m_physOfNode[node->GetId()];
+  m_grid->ForEachWithin(node, m_maxRange + m_guard, [this, &receivers] (Ptr<Node> neighbor) {
+    if (neighbor->GetId() < m_physOfNode.size()) {
+      const std::vector<uint32_t>& phys = m_physOfNode[neighbor->GetId()];
+      receivers.insert(receivers.end(), phys.begin(), phys.end());
+    }
+  });
+  /* Same order of reception events as the full channel */
+  std::sort(receivers.begin(), receivers.end());
+}
+
+void
+RangeCulledWifiChannel::IndexPhys() const
+{
+  m_physOfNode.clear();
+  for (uint32_t i = 0; i < GetNDevices(); ++i) {
+    Ptr<Node> node = GetDevice(i)->GetNode();
+    NS_ABORT_MSG_IF(!m_grid->Contains(node), "Node " << node->GetId() << " is not in the grid");
+    if (node->GetId() >= m_physOfNode.size())
+      m_physOfNode.resize(node->GetId() + 1);
+    m_physOfNode[node->GetId()].push_back(i);
+  }
+  m_indexedPhys = GetNDevices();
+}
+
+} // namespace ndn
+} // namespace ns3
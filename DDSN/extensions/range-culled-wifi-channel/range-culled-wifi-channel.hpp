@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#pragma once
+
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+
+#include <vector>
+
+#include "../mobility-grid/mobility-grid.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief YansWifiChannel that only delivers a transmission to the PHYs
+ *        within MaxRange plus Guard of the sender.
+ *
+ * Meant for a RangePropagationLossModel of the same MaxRange, beyond which
+ * every PHY drops the packet anyway: the PHYs in range receive it exactly
+ * as on a plain YansWifiChannel, and the cost of a transmission grows with
+ * the number of neighbors instead of the number of nodes. The only visible
+ * difference is that PHYs out of range no longer count it in PhyRxDrop.
+ *
+ * Needs the YansWifiChannel of changed_ndnSIM_files, and a MobilityGrid
+ * over every node on the channel.
+ */
+class RangeCulledWifiChannel : public YansWifiChannel
+{
+public:
+  static TypeId
+  GetTypeId();
+
+  RangeCulledWifiChannel();
+
+  void
+  SetGrid(MobilityGrid* grid)
+  {
+    m_grid = grid;
+  }
+
+protected:
+  virtual void
+  GetReceivers(Ptr<YansWifiPhy> sender, std::vector<uint32_t>& receivers) const override;
+
+private:
+  /* Map nodes to their PHYs on this channel, after PHYs were added */
+  void
+  IndexPhys() const;
+
+  double m_maxRange;
+  double m_guard;
+  MobilityGrid* m_grid;
+  mutable std::vector<std::vector<uint32_t>> m_physOfNode;    /* By node id */
+  mutable uint32_t m_indexedPhys;
+};
+
+} // namespace ndn
+} // namespace ns3
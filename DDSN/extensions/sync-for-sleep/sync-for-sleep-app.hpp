@@ -14,8 +14,11 @@
 #include "ns3/mobility-module.h"
 
 #include "ns3/ndnSIM/NFD/daemon/table/pit.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
 
 #include "sync-sleep-node.hpp"
+#include "../mobility-grid/mobility-grid.hpp"
+#include "convergence-oracle.hpp"
 
 using nfd::pit::Pit;
 
@@ -48,16 +51,7 @@ public:
   }
 
   int GetNumSurroundingNodes_() {
-    int num = 0;
-    for (NodeContainer::Iterator i = container_->Begin(); i != container_->End(); ++i) {
-      if (*i == GetNode())
-        continue;
-      double distance = (GetNode() -> GetObject<MobilityModel>())
-                        -> GetDistanceFrom((*i) -> GetObject<MobilityModel>());
-      if (distance <= wifi_range + 1e-3)
-        num += 1;
-    }
-    return num;
+    return grid_->CountWithin(GetNode(), wifi_range + 1e-3);
   }
 
   bool IsImportantData(uint64_t node_id) {
@@ -66,8 +60,24 @@ public:
     return true;
   }
 
-  NodeContainer *container_;  // Point back to container in simulator
+  void
+  PrintStatistics()
+  {
+    if (m_instance)
+      m_instance->PrintStatistics();
+  }
+
+  void
+  SaveSnapshot(vsync::proto::NodeSnapshot& snapshot) const
+  {
+    if (m_instance)
+      m_instance->SaveSnapshot(snapshot);
+  }
+
+  MobilityGrid *grid_;        // Index of all nodes in simulator
   float wifi_range;           // Wifi range from simulator to calculate num of surrounding nodes
+  vsync::ConvergenceOracle *oracle_ = nullptr;  // Simulation-wide convergence, if enabled
+  const vsync::proto::NodeSnapshot *snapshot_ = nullptr;  // Checkpoint to continue from, if any
 
 
 protected:
@@ -82,6 +92,11 @@ protected:
       std::bind(&SyncForSleepApp::GetCurrentPosition, this),
       std::bind(&SyncForSleepApp::GetNumSurroundingNodes_, this)
     ));
+    AddForwarderGauges();
+    if (oracle_ != nullptr)
+      ReportToOracle();
+    if (snapshot_ != nullptr && !m_instance->LoadSnapshot(*snapshot_))
+      NS_FATAL_ERROR("Cannot restore node " << nid_ << " from its snapshot");
     m_instance->Start();
   }
 
@@ -93,6 +108,49 @@ protected:
   }
 
 private:
+  /* Report stores to the oracle, which in turn tells the data store what is replicated */
+  void
+  ReportToOracle()
+  {
+    vsync::ConvergenceOracle* oracle = oracle_;
+    vsync::NodeID nid = nid_;
+    m_instance->SetOnStore(
+      [oracle, nid] (vsync::NodeID producer, uint64_t first, uint64_t last) {
+        oracle->OnDataStore(Simulator::Now().GetMicroSeconds(), nid, producer, first, last);
+      },
+      [oracle, nid] (vsync::NodeID producer, uint64_t first, uint64_t last) {
+        oracle->OnStateStore(Simulator::Now().GetMicroSeconds(), nid, producer, first, last);
+      });
+    m_instance->SetIsReplicated([oracle] (vsync::NodeID producer, uint64_t seq) {
+      return oracle->IsDataReplicated(producer, seq);
+    });
+  }
+
+  /* Sample the forwarder's packet counters along with the node's */
+  void
+  AddForwarderGauges()
+  {
+    using Counters = nfd::Forwarder::TrafficCounters;
+    static const std::pair<const char*, uint64_t Counters::*> kCounters[] = {
+      {"nfd.out_data", &Counters::outData},
+      {"nfd.out_ack", &Counters::outAck},
+      {"nfd.out_bundled_data", &Counters::outBundledData},
+      {"nfd.out_notify_interest", &Counters::outNotifyInterest},
+      {"nfd.out_beacon", &Counters::outBeacon},
+      {"nfd.out_bundled_interest", &Counters::outBundledInterest},
+      {"nfd.out_data_interest", &Counters::outDataInterest},
+      {"nfd.cache_hit", &Counters::cacheHit},
+      {"nfd.cache_hit_special", &Counters::cacheHitSpecial},
+    };
+    shared_ptr<nfd::Forwarder> forwarder = GetNode()->GetObject<L3Protocol>()->getForwarder();
+    for (const auto& counter : kCounters) {
+      uint64_t Counters::*field = counter.second;
+      m_instance->GetMetrics().AddGauge(counter.first, [forwarder, field] {
+        return static_cast<double>(forwarder->getTrafficCounters().*field);
+      });
+    }
+  }
+
   std::unique_ptr<vsync::sync_for_sleep::SimpleNode> m_instance;
   vsync::NodeID nid_;
   Name prefix_;
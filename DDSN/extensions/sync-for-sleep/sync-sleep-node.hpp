@@ -41,6 +41,30 @@ class SimpleNode {
   void Start() {
   }
 
+  metrics::MetricsRegistry& GetMetrics() {
+    return node_.GetMetrics();
+  }
+
+  void SetOnStore(const Node::OnStore& on_data_store, const Node::OnStore& on_state_store) {
+    node_.SetOnStore(on_data_store, on_state_store);
+  }
+
+  void SetIsReplicated(const DataStore::IsReplicated& is_replicated) {
+    node_.SetIsReplicated(is_replicated);
+  }
+
+  void PrintStatistics() {
+    node_.PrintStatistics();
+  }
+
+  void SaveSnapshot(proto::NodeSnapshot& snapshot) const {
+    node_.SaveSnapshot(snapshot);
+  }
+
+  bool LoadSnapshot(const proto::NodeSnapshot& snapshot) {
+    return node_.LoadSnapshot(snapshot);
+  }
+
   void OnData(const VersionVector& vv) {
   }
 
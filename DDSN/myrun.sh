@@ -15,9 +15,12 @@ run_loss_rate() {
     local RESULT_DIR=$2
     echo "Starting simulation: Loss rate = ${LOSS_RATE} ..."
     NS_LOG='SyncForSleep' ./waf --run "sync-for-sleep-movepattern --pauseTime=0 \
-        --run=0 --mobileNodeNum=${NODE_NUM} --lossRate=${LOSS_RATE} --wifiRange=60" \
+        --run=0 --mobileNodeNum=${NODE_NUM} --lossRate=${LOSS_RATE} --wifiRange=60 \
+        --convergence=0.9 --eventLog=${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.events \
+        --metrics=${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.metrics" \
         > ${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.txt 2>&1
-    python syncDuration.py ${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.txt ${NODE_NUM} \
+    ./build/sync-analyzer --nodes=${NODE_NUM} ${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.txt \
+        ${RESULT_DIR}/raw/loss_rate_${LOSS_RATE}.events \
         > ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt
 }
 
@@ -26,9 +29,12 @@ run_wifi_range() {
     local RESULT_DIR=$2
     echo "Starting simulation: Wifi range = ${WIFI_RANGE} ..."
     NS_LOG='SyncForSleep' ./waf --run "sync-for-sleep-movepattern --pauseTime=0 \
-        --run=0 --mobileNodeNum=${NODE_NUM} --lossRate=0 --wifiRange=${WIFI_RANGE} "\
+        --run=0 --mobileNodeNum=${NODE_NUM} --lossRate=0 --wifiRange=${WIFI_RANGE} \
+        --convergence=0.9 --eventLog=${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.events \
+        --metrics=${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.metrics" \
         > ${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.txt 2>&1
-    python syncDuration.py ${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.txt ${NODE_NUM} \
+    ./build/sync-analyzer --nodes=${NODE_NUM} ${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.txt \
+        ${RESULT_DIR}/raw/wifi_range_${WIFI_RANGE}.events \
         > ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt
 }
 
@@ -41,7 +47,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "out notify interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out notify interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Sync ack
@@ -49,7 +55,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "out ack" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out ack":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data interest
@@ -57,7 +63,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "out data interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out data interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data reply
@@ -65,7 +71,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "data reply" \
+            | grep '"data reply":' \
             >> ${RESULT_DIR}/${FILENAME}
             # | grep "out data" \
             # | grep -v "out data interest" \
@@ -104,7 +110,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "state sync delay" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"state sync delay":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data sync delay
@@ -112,7 +118,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "data sync delay" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"data sync delay":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Recv data
@@ -120,7 +126,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "recvDataReply" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"recvDataReply":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Forwarded data
@@ -128,7 +134,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "recvForwardedDataReply" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"recvForwardedDataReply":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Suppressed data
@@ -136,7 +142,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "recvSuppressedDataReply" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"recvSuppressedDataReply":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # # Number of collisions
@@ -152,7 +158,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "in notify interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"in notify interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Number of suppressed sync interests
@@ -160,7 +166,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "suppressed notify interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"suppressed notify interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Rate of collision
@@ -168,7 +174,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "collision rate" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"collision rate":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Repo reply rate
@@ -176,7 +182,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "repo reply rate" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"repo reply rate":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Hibernate duration
@@ -184,7 +190,7 @@ summarize_wifi_range_result() {
     for WIFI_RANGE in "${WIFI_RANGE_LIST[@]}"; do
         echo -n "Wifi range = ${WIFI_RANGE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/wifi_range_${WIFI_RANGE}.txt \
-            | grep "hibernate duration" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"hibernate duration":' >> ${RESULT_DIR}/${FILENAME}
     done
 }
 
@@ -197,7 +203,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "out notify interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out notify interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Sync ack
@@ -205,7 +211,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "out ack" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out ack":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data interest
@@ -213,7 +219,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "out data interest" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"out data interest":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data reply
@@ -221,7 +227,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "data reply" \
+            | grep '"data reply":' \
             >> ${RESULT_DIR}/${FILENAME}
     done
 
@@ -230,7 +236,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "state sync delay" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"state sync delay":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Data sync delay
@@ -238,7 +244,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "data sync delay" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"data sync delay":' >> ${RESULT_DIR}/${FILENAME}
     done
 
     # Rate of collision
@@ -246,7 +252,7 @@ summarize_loss_rate_result() {
     for LOSS_RATE in "${LOSS_RATE_LIST[@]}"; do
         echo -n "Loss rate = ${LOSS_RATE} " >> ${RESULT_DIR}/${FILENAME}
         cat ${RESULT_DIR}/loss_rate_${LOSS_RATE}.txt \
-            | grep "collision rate" >> ${RESULT_DIR}/${FILENAME}
+            | grep '"collision rate":' >> ${RESULT_DIR}/${FILENAME}
     done
 }
 
@@ -16,7 +16,7 @@ for i in $(seq 0 3); do
     for (( TIME=1; TIME<=$RUN_TIMES; TIME++ )); do
         echo "Running loss rate = ${LOSS_RATE_LIST[$i]}"
         NS_LOG='SyncForSleep' ./build/sync-for-sleep-movepattern --pauseTime=0 \
-            --run=0 --mobileNodeNum=${NODE_NUM} --lossRate=${LOSS_RATE_LIST[$i]} --wifiRange=60 \
+            --run=${TIME} --mobileNodeNum=${NODE_NUM} --lossRate=${LOSS_RATE_LIST[$i]} --wifiRange=60 \
             > result/loss_rate_${LOSS_RATE_DIR_NAME[$i]}/result_${TIME}.txt 2>&1 &
         pids="$pids $!"
     done
@@ -10,7 +10,14 @@
 
 #include "sync-for-sleep/sync-for-sleep-app.hpp"
 #include "pure-forwarder/pure-forwarder-app.hpp"
-
+#include "mobility-grid/mobility-grid.hpp"
+#include "range-culled-wifi-channel/range-culled-wifi-channel.hpp"
+#include "unit-disk/unit-disk-helper.hpp"
+#include "mobility/ns3-waypoint-mobility.hpp"
+#include "event-log/event-log.hpp"
+#include "metrics/metrics.hpp"
+
+#include <fstream>
 #include <random>
 #include <map>
 
@@ -101,6 +108,42 @@ static const int y_range = 800;
 static const int max_speed = 20;
 // wifi-coverage is about 160
 
+void StopAfterConvergence(NodeContainer* nodes) {
+  for (NodeContainer::Iterator i = nodes->Begin(); i != nodes->End(); ++i) {
+    auto app = DynamicCast<ns3::ndn::SyncForSleepApp>((*i)->GetApplication(0));
+    if (app)
+      app->PrintStatistics();
+  }
+  /* Leave time for the NFD statistics interests */
+  Simulator::Stop(Seconds(1));
+}
+
+/* Called once every data reached the target replication: stop after a grace period */
+void OnConverged(::ndn::vsync::ConvergenceOracle* oracle, NodeContainer* nodes, double grace) {
+  std::cout << "Converged at " << oracle->LastReplicationTime() / 1000000.0
+            << "s: " << oracle->NumItems() << " data on " << oracle->Target()
+            << " nodes, detected at " << Simulator::Now().GetSeconds() << "s" << std::endl;
+  Simulator::Schedule(Seconds(grace), &StopAfterConvergence, nodes);
+}
+
+/* Save the state of every sync node, to be continued with --restore */
+void WriteCheckpoint(NodeContainer* nodes, std::string path) {
+  ::ndn::vsync::proto::Checkpoint checkpoint;
+  checkpoint.set_time(Simulator::Now().GetMicroSeconds());
+  for (NodeContainer::Iterator i = nodes->Begin(); i != nodes->End(); ++i) {
+    auto app = DynamicCast<ns3::ndn::SyncForSleepApp>((*i)->GetApplication(0));
+    if (app)
+      app->SaveSnapshot(*checkpoint.add_node());
+  }
+  std::ofstream out(path.c_str(), std::ios::binary);
+  if (!checkpoint.SerializeToOstream(&out)) {
+    std::cerr << "Cannot write checkpoint " << path << std::endl;
+    return;
+  }
+  std::cout << "Checkpoint of " << checkpoint.node_size() << " nodes written at "
+            << Simulator::Now().GetSeconds() << "s to " << path << std::endl;
+}
+
 double getDistance(double x1, double y1, double x2, double y2) {
   return sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
 }
@@ -191,6 +234,16 @@ main (int argc, char *argv[])
   // bool useBeaconSuppression = false;
   bool useRetx = false;
   // bool useBeaconFlood = false;
+  std::string event_log;
+  std::string metrics;
+  int metrics_interval = 1000;
+  double convergence = 0;
+  double convergence_grace = 10;
+  std::string checkpoint_file;
+  double checkpoint_time = 0;
+  std::string restore_file;
+  bool cull_channel = false;
+  bool unit_disk = false;
   CommandLine cmd;
   cmd.AddValue("mobileNodeNum", "mobileNodeNum", mobile_node_num);
   cmd.AddValue("constantPause", "if the pause_time is constant", constant_pause);
@@ -205,11 +258,31 @@ main (int argc, char *argv[])
   // cmd.AddValue("useBeaconSuppression", "useBeaconSuppression", useBeaconSuppression);
   cmd.AddValue("useRetx", "useRetx", useRetx);
   // cmd.AddValue("useBeaconFlood", "useBeaconFlood", useBeaconFlood);
+  cmd.AddValue("eventLog", "binary event log file", event_log);
+  cmd.AddValue("metrics", "prefix of the metrics .json and .csv files", metrics);
+  cmd.AddValue("metricsInterval", "metrics sampling interval in ms", metrics_interval);
+  cmd.AddValue("convergence", "stop once every data reaches this fraction of nodes (0: never)",
+               convergence);
+  cmd.AddValue("convergenceGrace", "seconds to keep running after convergence", convergence_grace);
+  cmd.AddValue("checkpoint", "file to save the state of every sync node to", checkpoint_file);
+  cmd.AddValue("checkpointTime", "simulated time of the checkpoint in seconds", checkpoint_time);
+  cmd.AddValue("restore", "checkpoint to continue from, taken with the same trace", restore_file);
+  cmd.AddValue("cullChannel", "only deliver transmissions to nodes within wifi range",
+               cull_channel);
+  cmd.AddValue("unitDisk", "fast mode: unit-disk devices instead of wifi", unit_disk);
   cmd.Parse (argc,argv);
+  if (!event_log.empty())
+    ::ndn::eventlog::EventLogWriter::Instance().Open(event_log);
+  if (!metrics.empty())
+    ::ndn::metrics::MetricsExporter::Instance().Open(metrics, metrics_interval);
   assert(range != -1);
   int node_num = mobile_node_num + 0;
   if (mobile_node_num <= 5) node_num = mobile_node_num; // TODO: remove
   RngSeedManager::SetRun (run);
+  /* Node timers draw from streams of this seed and run, see vsync/lib/random-stream.hpp */
+  std::cout << "Random seed = " << RngSeedManager::GetSeed() << ", run = " << run
+            << " (replay with --RngSeed=" << RngSeedManager::GetSeed() << " --run=" << run << ")"
+            << std::endl;
 
   //////////////////////
   //////////////////////
@@ -229,7 +302,19 @@ main (int argc, char *argv[])
   // YansWifiPhy wifiPhy = YansWifiPhy::Default();
   // /*
   YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default ();
-  wifiPhyHelper.SetChannel (wifiChannel.Create ());
+  Ptr<ns3::ndn::RangeCulledWifiChannel> culledChannel;
+  if (cull_channel) {
+    /* Same propagation as wifiChannel, evaluated for nodes in range only */
+    Ptr<RangePropagationLossModel> loss = CreateObject<RangePropagationLossModel> ();
+    loss->SetAttribute ("MaxRange", DoubleValue(range));
+    culledChannel = CreateObject<ns3::ndn::RangeCulledWifiChannel> ();
+    culledChannel->SetAttribute ("MaxRange", DoubleValue(range));
+    culledChannel->SetPropagationLossModel (loss);
+    culledChannel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+    wifiPhyHelper.SetChannel (culledChannel);
+  }
+  else
+    wifiPhyHelper.SetChannel (wifiChannel.Create ());
   // */
 
   NqosWifiMacHelper wifiMacHelper = NqosWifiMacHelper::Default ();
@@ -241,19 +326,30 @@ main (int argc, char *argv[])
   // */
 
   ////////////////
-  // 1. Install Wifi
-  // /*
-  NetDeviceContainer wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, nodes);
-  // */
-
-  wifi.AssignStreams(wifiNetDevices, 0);  // Fix rng
+  // 1. Install Wifi, or unit-disk devices of the same range and rate in fast mode
+  if (unit_disk) {
+    ns3::ndn::UnitDiskHelper unitDisk;
+    unitDisk.SetChannelAttribute("Range", DoubleValue(range));
+    NetDeviceContainer unitDiskDevices = unitDisk.Install(nodes);
+    unitDisk.AssignStreams(unitDiskDevices, 0);  // Fix rng
+  }
+  else {
+    NetDeviceContainer wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, nodes);
+    wifi.AssignStreams(wifiNetDevices, 0);  // Fix rng
+  }
 
   // 2. Install Mobility model
   // installMobility(nodes, constant_pause, pause_time);
   auto traceFile = "trace/scenario-" + to_string(mobile_node_num) + ".ns_movements";
   // auto traceFile = "trace/scenario-test.ns_movements";
-  Ns2MobilityHelper ns2 = Ns2MobilityHelper (traceFile);
-  ns2.Install ();
+  /* From the table of mobility-convert if there is one */
+  ns3::ndn::InstallMobilityTrace(traceFile);
+
+  // Neighbor queries of the apps, cells of one wifi range
+  ns3::ndn::MobilityGrid grid(range);
+  grid.Add(nodes);
+  if (cull_channel)
+    culledChannel->SetGrid(&grid);
 
   // 3. Install NDN stack
   StackHelper ndnHelper;
@@ -264,6 +360,32 @@ main (int argc, char *argv[])
   // 4. Set Forwarding Strategy
   StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
 
+  // Convergence oracle, fed by every sync node
+  int sync_node_num = std::min(node_num, 20);
+  ::ndn::vsync::ConvergenceOracle oracle(sync_node_num, convergence);
+  if (convergence > 0) {
+    oracle.SetOnConverged(std::bind(&OnConverged, &oracle, &nodes, convergence_grace));
+    /* Nodes stop publishing generate_data_time after they start at 2s */
+    Simulator::Schedule(Seconds(2 + generate_data_time),
+                        &::ndn::vsync::ConvergenceOracle::StopGeneration, &oracle);
+  }
+
+  // Checkpoint to continue from, sync nodes idle until its time
+  ::ndn::vsync::proto::Checkpoint checkpoint;
+  std::map<uint64_t, const ::ndn::vsync::proto::NodeSnapshot*> snapshots;
+  if (!restore_file.empty()) {
+    std::ifstream in(restore_file.c_str(), std::ios::binary);
+    NS_ABORT_MSG_IF(!checkpoint.ParseFromIstream(&in), "Cannot read checkpoint " << restore_file);
+    for (const auto& snapshot : checkpoint.node())
+      snapshots[snapshot.nid()] = &snapshot;
+    std::cout << "Continuing from checkpoint at " << checkpoint.time() / 1000000.0 << "s" << std::endl;
+  }
+  if (!checkpoint_file.empty()) {
+    /* Nodes start their simulation 2s after the apps start at 2s */
+    NS_ABORT_MSG_IF(checkpoint_time < 4, "Checkpoint time must be at least 4s");
+    Simulator::Schedule(Seconds(checkpoint_time), &WriteCheckpoint, &nodes, checkpoint_file);
+  }
+
   // install SyncApp
   uint64_t idx = 0;
   for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); ++i) {
@@ -279,8 +401,14 @@ main (int argc, char *argv[])
       appHelper.SetAttribute("Prefix", StringValue("/"));
       appHelper.Install(object).Start(Seconds(2));
       auto app = DynamicCast<ns3::ndn::SyncForSleepApp>(object -> GetApplication(0));
-      app -> container_ = &nodes;
+      app -> grid_ = &grid;
       app -> wifi_range = range;
+      if (convergence > 0)
+        app -> oracle_ = &oracle;
+      if (!restore_file.empty()) {
+        NS_ABORT_MSG_IF(snapshots.count(idx) == 0, "No snapshot of node " << idx);
+        app -> snapshot_ = snapshots[idx];
+      }
     } else {
       AppHelper appHelper("PureForwarderApp");
       appHelper.SetAttribute("NodeID", UintegerValue(idx));
@@ -291,6 +419,7 @@ main (int argc, char *argv[])
     StackHelper::setLossRate(loss_rate, object);
     FibHelper::AddRoute(object, "/ndn/syncNotify", std::numeric_limits<int32_t>::max());
     FibHelper::AddRoute(object, "/ndn/vsyncData", std::numeric_limits<int32_t>::max());
+    FibHelper::AddRoute(object, "/ndn/bundledData", std::numeric_limits<int32_t>::max());
     idx++;
   }
 
@@ -298,7 +427,7 @@ main (int argc, char *argv[])
   // for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); ++i) {
   //   Ptr<Node> object = *i;
   //   auto app = DynamicCast<ns3::ndn::SyncForSleepApp>(object -> GetApplication(0));
-  //   app -> container_ = &nodes;
+  //   app -> grid_ = &grid;
   //   app -> wifi_range = range;
   // }
 
@@ -320,6 +449,9 @@ main (int argc, char *argv[])
 
   // L3RateTracer::InstallAll("test-rate-trace.txt", Seconds(0.5));
   // L2RateTracer::InstallAll("drop-trace.txt", Seconds(0.5));
+  /* Drain the event log before the process exits */
+  Simulator::ScheduleDestroy (&::ndn::eventlog::CloseEventLog);
+  Simulator::ScheduleDestroy (&::ndn::metrics::CloseMetrics);
   Simulator::Run ();
   Simulator::Destroy ();
   PrintDrop();
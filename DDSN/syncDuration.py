@@ -67,49 +67,62 @@ received_data_mobile = 0
 received_data_mobile_from_repo = 0
 hibernate_duration = []
 
+def store_data(time, data_name, line):
+    if data_name not in data_store:
+        data_store[data_name] = DataInfo(time)
+    else:
+        data_store[data_name].Owner += 1
+        data_store[data_name].LastTime = time
+    data_info = data_store[data_name]
+    if data_info.Owner > node_num_state_sync:
+        print line
+        print data_name
+        raise AssertionError()
+    elif not data_info.Available and data_info.Owner == int(0.9 * node_num_state_sync):
+        data_store[data_name].Available = True
+        cur_sync_duration = data_info.LastTime - data_info.GenerationTime
+        cur_sync_duration = float(cur_sync_duration) / 1000000.0
+        syncDuration.append(cur_sync_duration)
+
+def store_state(time, state_name, line):
+    if state_name not in state_store:
+        state_store[state_name] = DataInfo(time)
+    else:
+        state_store[state_name].Owner += 1
+        state_store[state_name].LastTime = time
+    state_info = state_store[state_name]
+    if state_info.Owner > node_num:
+        print line
+        print state_info.Owner
+        raise AssertionError()
+    elif not state_info.Available and state_info.Owner == int(0.9 * node_num):
+        state_store[state_name].Available = True
+        cur_sync_duration = state_info.LastTime - state_info.GenerationTime
+        cur_sync_duration = float(cur_sync_duration) / 1000000.0
+        stateSyncDuration.append(cur_sync_duration)
+    stateSyncTimestamp.append(float(state_info.LastTime - state_info.GenerationTime) / 1000000.0)
+
+# Data and state stores are in the binary event log if the run wrote one
+if len(sys.argv) > 3:
+    sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                 "..", "common", "event-log"))
+    import event_log
+    for time, node, event_type, key in event_log.read_events(sys.argv[3]):
+        if event_type == event_log.DATA_STORE:
+            store_data(time, key, key)
+        elif event_type == event_log.STATE_STORE:
+            store_state(time, key, key)
+
 # file_name = "adhoc-log/syncDuration-movepattern.txt"
 file = open(file_name)
 for line in file:
     if line.find("microseconds") != -1:
       if line.find("Store New Data") != -1:
         elements = line.split(' ')
-        time = elements[0]
-        data_name = elements[-1]
-        if data_name not in data_store:
-            data_store[data_name] = DataInfo(int(time))
-        else:
-            data_store[data_name].Owner += 1
-            data_store[data_name].LastTime = int(time)
-        data_info = data_store[data_name]
-        if data_info.Owner > node_num_state_sync:
-            print line
-            print data_name
-            raise AssertionError()
-        elif not data_info.Available and data_info.Owner == int(0.9 * node_num_state_sync):
-            data_store[data_name].Available = True
-            cur_sync_duration = data_info.LastTime - data_info.GenerationTime
-            cur_sync_duration = float(cur_sync_duration) / 1000000.0
-            syncDuration.append(cur_sync_duration)
+        store_data(int(elements[0]), elements[-1], line)
       elif line.find("Update New Seq") != -1:
         elements = line.split(' ')
-        time = elements[0]
-        state_name = elements[-1]
-        if state_name not in state_store:
-            state_store[state_name] = DataInfo(int(time))
-        else:
-            state_store[state_name].Owner += 1
-            state_store[state_name].LastTime = int(time)
-        state_info = state_store[state_name]
-        if state_info.Owner > node_num:
-            print line
-            print state_info.Owner
-            raise AssertionError()
-        elif not state_info.Available and state_info.Owner == int(0.9 * node_num):
-            state_store[state_name].Available = True
-            cur_sync_duration = state_info.LastTime - state_info.GenerationTime
-            cur_sync_duration = float(cur_sync_duration) / 1000000.0
-            stateSyncDuration.append(cur_sync_duration)
-        stateSyncTimestamp.append(float(state_info.LastTime - state_info.GenerationTime) / 1000000.0)
+        store_state(int(elements[0]), elements[-1], line)
     if line.find("NFD:") != -1:
       if line.find("m_outNotifyInterest") != -1:
         elements = line.split(' ')
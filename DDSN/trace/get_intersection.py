@@ -14,7 +14,7 @@ import json
 import matplotlib.pyplot as plt
 
 
-filename = "scenario-20.ns_movements"
+filename = sys.argv[1] if len(sys.argv) > 1 else "scenario-20.ns_movements"
 
 
 # Parse file
@@ -71,6 +71,24 @@ def read_trace(filename):
                 result[node]["dest_speed"] = dest_speed
     return result
             
+# Read a table of mobility-convert, see common/mobility/waypoint-table.hpp
+def read_waypoints(filename):
+    data = np.memmap(filename, dtype=np.uint8, mode="r")
+    header = np.frombuffer(data, count=1, dtype=[
+        ("magic", "S8"), ("version", "<u4"), ("nodes", "<u4"), ("waypoints", "<u8"),
+        ("source_size", "<u8"), ("source_hash", "<u8"), ("payload_hash", "<u8")])[0]
+    if header["magic"] != b"NDNWAYPT" or header["version"] != 1:
+        raise ValueError(filename + " is not a version 1 waypoint table")
+    nodes = int(header["nodes"])
+    offsets = np.frombuffer(data, dtype="<u8", count=nodes + 1, offset=header.nbytes)
+    table = np.frombuffer(data, dtype="<f8", count=4 * int(header["waypoints"]),
+                          offset=header.nbytes + offsets.nbytes).reshape(-1, 4)
+    result = dict()
+    for node in range(nodes):
+        waypoints = table[offsets[node]:offsets[node + 1]]
+        result[str(node)] = {"T": waypoints[:, 0], "X": waypoints[:, 1], "Y": waypoints[:, 2]}
+    return result
+
 # Get interpolated traces
 def interpolate_trace(t, x, y, start, end, num):
     t_interpolated = np.linspace(start, end, num)
@@ -198,7 +216,7 @@ def get_reconnect(traces, n, wifi_range):
     return durations
 
 if __name__ == "__main__":
-    traces = read_trace(filename)
+    traces = read_waypoints(filename) if filename.endswith(".wpt") else read_trace(filename)
     # Calculate contact duration
     durations_all = []
     for wifi_range in range(60, 161, 20):
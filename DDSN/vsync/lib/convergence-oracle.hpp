@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_CONVERGENCE_ORACLE_HPP_
+#define NDN_VSYNC_CONVERGENCE_ORACLE_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "version-vector.hpp"
+
+namespace ndn {
+namespace vsync {
+
+/**
+ * @brief Simulation-wide view of how far every data and state has spread.
+ *
+ * Every node reports what it stores. An item, i.e. a (producer, seq), is
+ * replicated once the target number of nodes hold it, the same criterion
+ * syncDuration.py uses for availability. After StopGeneration() no new items
+ * appear, so once every item known is replicated, both as data and as state,
+ * the network has converged and OnConverged is called, once.
+ *
+ * Node ids must be below the number of nodes given to the constructor.
+ */
+class ConvergenceOracle {
+ public:
+  using OnConverged = std::function<void()>;
+
+  /**
+   * @param num_nodes number of nodes reporting stores
+   * @param ratio fraction of them an item must reach, 0.9 in syncDuration.py
+   */
+  ConvergenceOracle(size_t num_nodes, double ratio)
+    : num_nodes_(num_nodes)
+    , target_(std::max<size_t>(1, static_cast<size_t>(ratio * num_nodes)))
+    , generation_stopped_(false)
+    , converged_(false)
+    , data_(num_nodes_, target_)
+    , state_(num_nodes_, target_)
+  {
+  }
+
+  void SetOnConverged(const OnConverged& on_converged) {
+    on_converged_ = on_converged;
+  }
+
+  /**
+   * @brief @p node stored the data of seqs in [@p first, @p last] of @p producer at @p time.
+   */
+  void OnDataStore(int64_t time, NodeID node, NodeID producer, uint64_t first, uint64_t last) {
+    data_.Add(time, node, producer, first, last);
+    CheckConverged();
+  }
+
+  /**
+   * @brief @p node learned seqs in [@p first, @p last] of @p producer at @p time.
+   */
+  void OnStateStore(int64_t time, NodeID node, NodeID producer, uint64_t first, uint64_t last) {
+    state_.Add(time, node, producer, first, last);
+    CheckConverged();
+  }
+
+  /**
+   * @brief No more data will be published, so convergence can be declared.
+   */
+  void StopGeneration() {
+    generation_stopped_ = true;
+    CheckConverged();
+  }
+
+  bool IsConverged() const {
+    return converged_;
+  }
+
+  /**
+   * @brief Whether the data of @p seq of @p producer has reached the target.
+   */
+  bool IsDataReplicated(NodeID producer, uint64_t seq) const {
+    return data_.IsReplicated(producer, seq);
+  }
+
+  /**
+   * @brief Time the last item got replicated, which is the convergence time
+   *        once IsConverged().
+   */
+  int64_t LastReplicationTime() const {
+    return std::max(data_.last_replicated, state_.last_replicated);
+  }
+
+  size_t NumItems() const {
+    return data_.items;
+  }
+
+  size_t NumPendingData() const {
+    return data_.items - data_.replicated;
+  }
+
+  size_t NumPendingState() const {
+    return state_.items - state_.replicated;
+  }
+
+  size_t Target() const {
+    return target_;
+  }
+
+ private:
+  struct Item {
+    std::vector<bool> holders;
+    size_t count = 0;
+  };
+
+  /* Holders of every seq of every producer, seq 1 at index 0 */
+  struct Tracker {
+    Tracker(size_t num_nodes, size_t target)
+      : num_nodes(num_nodes), target(target), items(0), replicated(0), last_replicated(0) {}
+
+    void Add(int64_t time, NodeID node, NodeID producer, uint64_t first, uint64_t last) {
+      if (node >= num_nodes || first == 0 || first > last)
+        return;
+      auto& items_of = seqs[producer];
+      if (last > items_of.size()) {
+        items += last - items_of.size();
+        items_of.resize(last);
+      }
+      for (uint64_t seq = first; seq <= last; ++seq) {
+        Item& item = items_of[seq - 1];
+        if (item.holders.empty())
+          item.holders.resize(num_nodes);
+        if (item.holders[node])
+          continue;
+        item.holders[node] = true;
+        if (++item.count == target) {
+          replicated++;
+          last_replicated = time;
+        }
+      }
+    }
+
+    bool IsReplicated(NodeID producer, uint64_t seq) const {
+      auto it = seqs.find(producer);
+      return it != seqs.end() && seq >= 1 && seq <= it->second.size() &&
+             it->second[seq - 1].count >= target;
+    }
+
+    size_t num_nodes;
+    size_t target;
+    std::unordered_map<NodeID, std::vector<Item>> seqs;
+    size_t items;
+    size_t replicated;
+    int64_t last_replicated;
+  };
+
+  void CheckConverged() {
+    if (converged_ || !generation_stopped_ || data_.items == 0 ||
+        data_.replicated < data_.items || state_.replicated < state_.items)
+      return;
+    converged_ = true;
+    if (on_converged_)
+      on_converged_();
+  }
+
+  size_t num_nodes_;
+  size_t target_;
+  bool generation_stopped_;
+  bool converged_;
+  Tracker data_;
+  Tracker state_;
+  OnConverged on_converged_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_CONVERGENCE_ORACLE_HPP_
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "data-store.hpp"
+
+namespace ndn {
+namespace vsync {
+
+DataStore::DataStore()
+  : policy_(kOldestFirst)
+  , budget_(0)
+  , bytes_(0)
+  , stats_{0, 0, 0, 0}
+{
+}
+
+void DataStore::SetBudget(size_t bytes) {
+  budget_ = bytes;
+  while (budget_ != 0 && bytes_ > budget_ && !order_.empty())
+    Evict();
+}
+
+void DataStore::SetEvictionPolicy(EvictionPolicy policy) {
+  policy_ = policy;
+}
+
+void DataStore::SetIsReplicated(const IsReplicated& is_replicated) {
+  is_replicated_ = is_replicated;
+}
+
+void DataStore::Pin(NodeID nid) {
+  pinned_.insert(nid);
+}
+
+void DataStore::Insert(NodeID nid, uint64_t seq, std::shared_ptr<const Data> data) {
+  size_t idx = NodeIndex::Get(nid);
+  if (tables_.size() <= idx)
+    tables_.resize(idx + 1);
+  Table& table = tables_[idx];
+  if (table.entries.empty())
+    table.base = seq;
+  if (seq < table.base) {
+    table.entries.insert(table.entries.begin(), table.base - seq, Entry());
+    table.base = seq;
+  }
+  if (table.entries.size() <= seq - table.base)
+    table.entries.resize(seq - table.base + 1);
+
+  Entry& entry = table.entries[seq - table.base];
+  if (entry.data) {
+    bytes_ -= entry.data->wireEncode().size();
+    (entry.pinned ? pinned_order_ : order_).erase(entry.order);
+  }
+  entry.pinned = pinned_.count(nid) > 0;
+  std::list<Key>& order = entry.pinned ? pinned_order_ : order_;
+  bytes_ += data->wireEncode().size();
+  entry.data = std::move(data);
+  entry.order = order.insert(order.end(), Key{nid, seq});
+  stats_.insertions++;
+
+  while (budget_ != 0 && bytes_ > budget_ && !order_.empty())
+    Evict();
+}
+
+std::shared_ptr<const Data> DataStore::Find(NodeID nid, uint64_t seq) {
+  Entry* entry = Lookup(nid, seq);
+  if (entry == nullptr) {
+    stats_.misses++;
+    return nullptr;
+  }
+  stats_.hits++;
+  if (policy_ == kLeastRecentlyUsed && !entry->pinned)
+    order_.splice(order_.end(), order_, entry->order);
+  return entry->data;
+}
+
+bool DataStore::WasStored(NodeID nid, uint64_t seq) const {
+  size_t idx = NodeIndex::Find(nid);
+  if (idx >= tables_.size())
+    return false;
+  return boost::icl::contains(tables_[idx].evicted, seq) || Lookup(nid, seq) != nullptr;
+}
+
+size_t DataStore::Slots() const {
+  size_t slots = 0;
+  for (const auto& table : tables_)
+    slots += table.entries.size();
+  return slots;
+}
+
+const DataStore::Entry* DataStore::Slot(NodeID nid, uint64_t seq) const {
+  size_t idx = NodeIndex::Find(nid);
+  if (idx >= tables_.size())
+    return nullptr;
+  const Table& table = tables_[idx];
+  if (seq < table.base || seq - table.base >= table.entries.size())
+    return nullptr;
+  return &table.entries[seq - table.base];
+}
+
+const DataStore::Entry* DataStore::Lookup(NodeID nid, uint64_t seq) const {
+  const Entry* entry = Slot(nid, seq);
+  return entry != nullptr && entry->data ? entry : nullptr;
+}
+
+void DataStore::Evict() {
+  auto victim = order_.begin();
+  if (policy_ == kReplicatedFirst && is_replicated_) {
+    size_t scanned = 0;
+    for (auto it = order_.begin(); it != order_.end() && scanned < kReplicatedScanLimit;
+         ++it, ++scanned) {
+      if (is_replicated_(it->nid, it->seq)) {
+        victim = it;
+        break;
+      }
+    }
+  }
+  Erase(victim);
+  stats_.evictions++;
+}
+
+void DataStore::Erase(std::list<Key>::iterator it) {
+  Key key = *it;
+  Entry* entry = Lookup(key.nid, key.seq);
+  bytes_ -= entry->data->wireEncode().size();
+  entry->data.reset();
+  order_.erase(it);
+
+  /* Drop the leading entries left without data */
+  Table& table = tables_[NodeIndex::Find(key.nid)];
+  table.evicted.insert(key.seq);
+  while (!table.entries.empty() && !table.entries.front().data) {
+    table.entries.pop_front();
+    table.base++;
+  }
+}
+
+}  // namespace vsync
+}  // namespace ndn
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_DATA_STORE_HPP_
+#define NDN_VSYNC_DATA_STORE_HPP_
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <ndn-cxx/data.hpp>
+
+#include "recv-window.hpp"
+#include "vsync-common.hpp"
+#include "vsync-helper.hpp"
+
+namespace ndn {
+namespace vsync {
+
+/**
+ * @brief Data store keyed by (producer, seq).
+ *
+ * Each producer has a table indexed by seq, and producers are found through
+ * the shared NodeIndex, so a lookup is two array accesses once the name is
+ * parsed. With a memory budget set, inserting beyond it evicts entries
+ * according to the eviction policy:
+ *  - kOldestFirst: in insertion order
+ *  - kReplicatedFirst: oldest entry the IsReplicated callback reports as held
+ *    everywhere, looking at the kReplicatedScanLimit oldest entries and
+ *    falling back to the oldest one
+ *  - kLeastRecentlyUsed: least recently inserted or served by Find()
+ * Data of pinned producers (e.g. the node's own) is never evicted.
+ *
+ * A table only spans the seqs from its oldest stored data on: leading entries
+ * are dropped as their data is evicted, and evicted seqs are remembered as
+ * intervals for WasStored(). So the budget bounds memory up to the gaps.
+ */
+class DataStore {
+ public:
+  enum EvictionPolicy {
+    kOldestFirst,
+    kReplicatedFirst,
+    kLeastRecentlyUsed
+  };
+
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+  };
+
+  using IsReplicated = std::function<bool(NodeID, uint64_t)>;
+
+  DataStore();
+
+  /**
+   * @brief Bound the wire size of stored data. A budget of 0 means unbounded.
+   */
+  void SetBudget(size_t bytes);
+
+  void SetEvictionPolicy(EvictionPolicy policy);
+
+  void SetIsReplicated(const IsReplicated& is_replicated);
+
+  /**
+   * @brief Never evict data of @p nid. Applies to data inserted afterwards.
+   */
+  void Pin(NodeID nid);
+
+  /**
+   * @brief Store @p data as (@p nid, @p seq), replacing any previous one.
+   */
+  void Insert(NodeID nid, uint64_t seq, std::shared_ptr<const Data> data);
+
+  void Insert(const Name& n, std::shared_ptr<const Data> data) {
+    Insert(ExtractNodeID(n), ExtractSequence(n), std::move(data));
+  }
+
+  /**
+   * @brief Look up data to serve it. Counts a hit or a miss.
+   * @return nullptr if not stored
+   */
+  std::shared_ptr<const Data> Find(NodeID nid, uint64_t seq);
+
+  std::shared_ptr<const Data> Find(const Name& n) {
+    return Find(ExtractNodeID(n), ExtractSequence(n));
+  }
+
+  /**
+   * @brief Whether data is stored, without touching counters or LRU order.
+   */
+  bool Contains(NodeID nid, uint64_t seq) const {
+    return Lookup(nid, seq) != nullptr;
+  }
+
+  bool Contains(const Name& n) const {
+    return Contains(ExtractNodeID(n), ExtractSequence(n));
+  }
+
+  /**
+   * @brief Whether data was stored at some point, even if evicted since.
+   */
+  bool WasStored(NodeID nid, uint64_t seq) const;
+
+  /* Number of stored data */
+  size_t size() const {
+    return order_.size() + pinned_order_.size();
+  }
+
+  /* Number of per-seq entries held, with or without data */
+  size_t Slots() const;
+
+  /* Wire size of stored data */
+  size_t Bytes() const {
+    return bytes_;
+  }
+
+  const Stats& GetStats() const {
+    return stats_;
+  }
+
+  /* E.g. to carry the counters over from a checkpoint */
+  void SetStats(const Stats& stats) {
+    stats_ = stats;
+  }
+
+  /**
+   * @brief Call @p f(nid, seq, data) for every stored data, pinned first,
+   *        each in eviction order. Inserting them in this order into an empty
+   *        store recreates the same order.
+   */
+  template <typename F>
+  void ForEach(const F& f) const {
+    for (const auto& key : pinned_order_)
+      f(key.nid, key.seq, Lookup(key.nid, key.seq)->data);
+    for (const auto& key : order_)
+      f(key.nid, key.seq, Lookup(key.nid, key.seq)->data);
+  }
+
+ private:
+  static const size_t kReplicatedScanLimit = 64;
+
+  struct Key {
+    NodeID nid;
+    uint64_t seq;
+  };
+
+  struct Entry {
+    std::shared_ptr<const Data> data;
+    std::list<Key>::iterator order;   /* Position in eviction order */
+    bool pinned = false;              /* order points into pinned_order_ */
+  };
+
+  struct Table {
+    uint64_t base = 0;                /* Seq of entries.front() */
+    std::deque<Entry> entries;
+    ReceiveWindow::SeqNumIntervalSet evicted;
+  };
+
+  /* Entry of (@p nid, @p seq) whether or not it holds data, nullptr if none */
+  const Entry* Slot(NodeID nid, uint64_t seq) const;
+
+  const Entry* Lookup(NodeID nid, uint64_t seq) const;
+
+  Entry* Lookup(NodeID nid, uint64_t seq) {
+    return const_cast<Entry*>(static_cast<const DataStore*>(this)->Lookup(nid, seq));
+  }
+
+  void Evict();
+
+  void Erase(std::list<Key>::iterator it);
+
+  std::vector<Table> tables_;                /* [NodeIndex] */
+  std::list<Key> order_;                     /* Evictable entries, first to evict first */
+  std::list<Key> pinned_order_;              /* Entries of pinned producers */
+  std::unordered_set<NodeID> pinned_;
+  EvictionPolicy policy_;
+  IsReplicated is_replicated_;
+  size_t budget_;
+  size_t bytes_;
+  Stats stats_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_DATA_STORE_HPP_
@@ -21,6 +21,11 @@
 
 #include "logging.hpp"
 
+#include <cmath>
+
+#include "event-log/event-log.hpp"
+#include "vsync-helper.hpp"
+
 namespace ndn {
 namespace vsync {
 Logger::Logger(uint64_t nid)
@@ -47,7 +52,8 @@ Logger::logDataStore(const Name& name)
   if (!is_enabled)
     return;
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Store New Data: " << name.toUri() << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kDataStore,
+                     ExtractNodeID(name), ExtractSequence(name));
 }
 
 void
@@ -55,10 +61,18 @@ Logger::logStateStore(const NodeID& nid, int64_t seq)
 {
   if (!is_enabled)
     return;
-  std::string state_tag = to_string(nid) + "-" + to_string(seq);
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-            << state_tag << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kStateStore, nid, seq);
+}
+
+void
+Logger::logStateStore(const NodeID& nid, uint64_t first_seq, uint64_t last_seq)
+{
+  if (!is_enabled)
+    return;
+  int64_t now = ns3::Simulator::Now().GetMicroSeconds();
+  for (uint64_t seq = first_seq; seq <= last_seq; ++seq)
+    eventlog::LogEvent(now, m_nid, eventlog::kStateStore, nid, seq);
 }
 
 void
@@ -67,8 +81,7 @@ Logger::logDist(double dist)
   if (!is_enabled)
     return;
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Travelled Distance: "
-            << dist << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kDistance, m_nid, std::llround(dist * 1000));
 }
 
 
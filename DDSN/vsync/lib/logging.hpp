@@ -31,13 +31,38 @@
 #include "ndn-common.hpp"
 #include "vsync-common.hpp"
 
+/**
+ * Log statements above VSYNC_MAX_LOG_LEVEL are compiled out. The level is
+ * set with "./waf configure --vsync-log-level=<level>"; benchmark builds use
+ * "info" or lower so the trace statements on the packet path cost nothing.
+ * Logger, which writes the event log used for statistics, is not affected.
+ */
+#define VSYNC_LOG_LEVEL_NONE 0
+#define VSYNC_LOG_LEVEL_ERROR 1
+#define VSYNC_LOG_LEVEL_WARN 2
+#define VSYNC_LOG_LEVEL_INFO 3
+#define VSYNC_LOG_LEVEL_DEBUG 4
+#define VSYNC_LOG_LEVEL_TRACE 5
+
+#ifndef VSYNC_MAX_LOG_LEVEL
+#define VSYNC_MAX_LOG_LEVEL VSYNC_LOG_LEVEL_TRACE
+#endif
+
+/* The disabled branch is still type-checked, but never emitted */
+#define VSYNC_LOG_AT(level, statement)                  \
+  do {                                                  \
+    if (::ndn::vsync::kMaxLogLevel >= (level)) {        \
+      statement;                                        \
+    }                                                   \
+  } while (false)
+
 #define VSYNC_LOG_DEFINE(name) NS_LOG_COMPONENT_DEFINE(#name)
 
-#define VSYNC_LOG_TRACE(expr) NS_LOG_LOGIC(expr)
-#define VSYNC_LOG_INFO(expr) NS_LOG_INFO(expr)
-#define VSYNC_LOG_DEBUG(expr) NS_LOG_DEBUG(expr)
-#define VSYNC_LOG_WARN(expr) NS_LOG_WARN(expr)
-#define VSYNC_LOG_ERROR(expr) NS_LOG_ERROR(expr)
+#define VSYNC_LOG_TRACE(expr) VSYNC_LOG_AT(VSYNC_LOG_LEVEL_TRACE, NS_LOG_LOGIC(expr))
+#define VSYNC_LOG_INFO(expr) VSYNC_LOG_AT(VSYNC_LOG_LEVEL_INFO, NS_LOG_INFO(expr))
+#define VSYNC_LOG_DEBUG(expr) VSYNC_LOG_AT(VSYNC_LOG_LEVEL_DEBUG, NS_LOG_DEBUG(expr))
+#define VSYNC_LOG_WARN(expr) VSYNC_LOG_AT(VSYNC_LOG_LEVEL_WARN, NS_LOG_WARN(expr))
+#define VSYNC_LOG_ERROR(expr) VSYNC_LOG_AT(VSYNC_LOG_LEVEL_ERROR, NS_LOG_ERROR(expr))
 
 /*
 #else
@@ -59,6 +84,11 @@
 namespace ndn {
 namespace vsync {
 
+constexpr int kMaxLogLevel = VSYNC_MAX_LOG_LEVEL;
+
+/**
+ * @brief Per-node front end of the binary event log (common/event-log).
+ */
 class Logger {
 public:
   Logger(uint64_t nid);
@@ -75,6 +105,12 @@ public:
   void
   logStateStore(const NodeID& nid, int64_t seq);
 
+  /**
+   * @brief Log every state in [first_seq, last_seq] of producer @p nid
+   */
+  void
+  logStateStore(const NodeID& nid, uint64_t first_seq, uint64_t last_seq);
+
   void
   logDist(double dist);
 
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_MISSING_DATA_HPP_
+#define NDN_VSYNC_MISSING_DATA_HPP_
+
+#include <algorithm>
+#include <map>
+
+#include "recv-window.hpp"
+
+namespace ndn {
+namespace vsync {
+
+/**
+ * @brief Per-producer sets of missing sequence numbers not yet requested.
+ *
+ * A gap learned from a state vector is stored as one interval, so memory is
+ * bounded by the number of gaps rather than the number of missing data. The
+ * node turns entries into data interests one at a time with Next().
+ *
+ * Producers are served round robin, so a long gap of one producer does not
+ * hold back the data of the others.
+ */
+class MissingDataTracker {
+ public:
+  using SeqNumInterval = ReceiveWindow::SeqNumInterval;
+  using SeqNumIntervalSet = ReceiveWindow::SeqNumIntervalSet;
+
+  MissingDataTracker() : size_(0), next_nid_(0) {}
+
+  /**
+   * @brief Mark seqs in [@p first, @p last] of @p nid as missing.
+   */
+  void Insert(NodeID nid, uint64_t first, uint64_t last) {
+    if (first > last)
+      return;
+    auto& win = missing_[nid];
+    size_ -= win.size();
+    win.insert(SeqNumInterval::closed(first, last));
+    size_ += win.size();
+  }
+
+  bool Contains(NodeID nid, uint64_t seq) const {
+    auto it = missing_.find(nid);
+    return it != missing_.end() && boost::icl::contains(it->second, seq);
+  }
+
+  /**
+   * @brief Forget @p seq of @p nid, e.g. because its data has arrived.
+   */
+  bool Erase(NodeID nid, uint64_t seq) {
+    auto it = missing_.find(nid);
+    if (it == missing_.end() || !boost::icl::contains(it->second, seq))
+      return false;
+    it->second.erase(seq);
+    --size_;
+    if (it->second.empty())
+      missing_.erase(it);
+    return true;
+  }
+
+  /**
+   * @brief Take the lowest missing seq of the producer after the one served
+   *        last.
+   * @return false if nothing is missing
+   */
+  bool Next(NodeID& nid, uint64_t& seq) {
+    if (missing_.empty())
+      return false;
+    auto it = missing_.lower_bound(next_nid_);
+    if (it == missing_.end())
+      it = missing_.begin();
+    nid = it->first;
+    seq = boost::icl::first(*it->second.begin());
+    Erase(nid, seq);
+    next_nid_ = nid + 1;
+    return true;
+  }
+
+  /**
+   * @brief Take the first run of more than @p threshold consecutive missing
+   *        seqs, at most @p max_len of it, starting from the producer after
+   *        the one served last.
+   * @return false if there is no such run
+   */
+  bool NextRange(size_t threshold, size_t max_len,
+                 NodeID& nid, uint64_t& first, uint64_t& last) {
+    auto it = missing_.lower_bound(next_nid_);
+    for (size_t n = 0; n < missing_.size(); ++n, ++it) {
+      if (it == missing_.end())
+        it = missing_.begin();
+      for (const auto& interval : it->second) {
+        uint64_t len = boost::icl::length(interval);
+        if (len <= threshold)
+          continue;
+        nid = it->first;
+        first = boost::icl::first(interval);
+        last = first + std::min<uint64_t>(len, max_len) - 1;
+        auto& win = missing_[nid];
+        win.erase(SeqNumInterval::closed(first, last));
+        size_ -= last - first + 1;
+        if (win.empty())
+          missing_.erase(nid);
+        next_nid_ = nid + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Number of missing data */
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @brief Call @p f(nid, first, last) for every gap.
+   */
+  template <typename F>
+  void ForEachRange(const F& f) const {
+    for (const auto& entry : missing_) {
+      for (const auto& interval : entry.second)
+        f(entry.first, boost::icl::first(interval), boost::icl::last(interval));
+    }
+  }
+
+  /* Number of gaps */
+  size_t NumRanges() const {
+    size_t n = 0;
+    for (const auto& entry : missing_)
+      n += entry.second.iterative_size();
+    return n;
+  }
+
+ private:
+  std::map<NodeID, SeqNumIntervalSet> missing_;
+  size_t size_;
+  NodeID next_nid_;  /* Producer to serve first, round robin */
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_MISSING_DATA_HPP_
@@ -8,12 +8,24 @@
 
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include "ns3/rng-seed-manager.h"
 
 VSYNC_LOG_DEFINE(SyncForSleep);
 
 namespace ndn {
 namespace vsync {
 
+/* Log-scale buckets from 1ms, about 25% wide, so quantiles stay within 25% */
+static const std::vector<double> kSyncLatencyBounds =
+  metrics::Histogram::ExponentialBounds(1, 1.25, 64);
+
+/* Derived from the ns-3 seed and run number, so --run reproduces a run */
+static uint64_t
+RandomSeed(NodeID nid, RandomStream::Purpose purpose)
+{
+  return RandomStream::Seed(ns3::RngSeedManager::GetSeed(), ns3::RngSeedManager::GetRun(),
+                            nid, purpose);
+}
 
 /* Public */
 Node::Node(Face &face, Scheduler &scheduler, KeyChain &key_chain, const NodeID &nid,
@@ -24,13 +36,25 @@ Node::Node(Face &face, Scheduler &scheduler, KeyChain &key_chain, const NodeID &
   , key_chain_(key_chain)
   , nid_(nid)
   , prefix_(prefix)
-  , rengine_(rdevice_())
+  , data_generation_rng_(RandomSeed(nid_, RandomStream::kDataGeneration))
+  , packet_rng_(RandomSeed(nid_, RandomStream::kPacket))
+  , retx_rng_(RandomSeed(nid_, RandomStream::kRetx))
+  , ack_rng_(RandomSeed(nid_, RandomStream::kAck))
+  , mhop_rng_(RandomSeed(nid_, RandomStream::kMultiHop))
   , logger(nid_)
   , data_cb_(std::move(on_data))
   , is_important_data_(is_important_data)
   , getCurrentPos_(getCurrentPos)
   , getNumSurroundingNodes_(getNumSurroundingNodes)
   , odometer(getCurrentPos, face_.getIoService())
+  , metrics_(nid_)
+  , suppressed_sync_interest(metrics_.GetCounter("suppressed_sync_interest"))
+  , data_reply(metrics_.GetCounter("data_reply"))
+  , should_receive_sync_interest(metrics_.GetCounter("should_receive_sync_interest"))
+  , received_sync_interest(metrics_.GetCounter("received_sync_interest"))
+  , received_data_interest(metrics_.GetCounter("received_data_interest"))
+  , received_data_mobile(metrics_.GetCounter("received_data_mobile"))
+  , received_data_mobile_from_repo(metrics_.GetCounter("received_data_mobile_from_repo"))
 {
 
   /* Set interest filters */
@@ -46,15 +70,14 @@ Node::Node(Face &face, Scheduler &scheduler, KeyChain &key_chain, const NodeID &
       VSYNC_LOG_TRACE( "node(" << nid_ << ") Failed to register data prefix: " << reason);
       throw Error("Failed to register data prefix: " + reason);
   });
+  face_.setInterestFilter(
+    Name(kBundledDataPrefix), std::bind(&Node::OnBundledDataInterest, this, _2),
+    [this](const Name&, const std::string& reason) {
+      VSYNC_LOG_TRACE( "node(" << nid_ << ") Failed to register bundled data prefix: " << reason);
+      throw Error("Failed to register bundled data prefix: " + reason);
+  });
 
   /* Initialize statistics */
-  received_sync_interest =          0;
-  suppressed_sync_interest =        0;
-  should_receive_sync_interest =    0;
-  received_data_interest =          0;
-  data_reply =                      0;
-  received_data_mobile =            0;
-  received_data_mobile_from_repo =  0;
   hibernate_start =                 0;
   hibernate_duration =              0;
 
@@ -66,6 +89,21 @@ Node::Node(Face &face, Scheduler &scheduler, KeyChain &key_chain, const NodeID &
   num_scheduler_retx = 0;
   num_scheduler_retx_inf = 0;
   pending_forward = 0;
+  rounds_since_full_vv_ = 0;
+  force_full_vv_ = true;
+  encoded_vv_valid_ = false;
+
+  /* Configure data store. Own data is never evicted */
+  data_store_.SetBudget(kDataStoreBudget);
+  data_store_.SetEvictionPolicy(kDataStoreEviction);
+  data_store_.Pin(nid_);
+
+  /* Configure send queue. Only the latest sync interest is worth sending */
+  send_queue_.SetScheduling(kSendQueueScheduling);
+  send_queue_.SetQuantum(kMaxDataContent);
+  for (size_t i = 0; i < SendQueue::kNumTypes; ++i)
+    send_queue_.SetWeight(static_cast<SendQueue::Type>(i), kSendQueueWeights[i]);
+  send_queue_.SetLimit(SendQueue::kSyncInterest, 1, SendQueue::kDropHead);
 
   // if (nid_ >= 20) {
   // // if (nid_ == 1) {
@@ -76,44 +114,49 @@ Node::Node(Face &face, Scheduler &scheduler, KeyChain &key_chain, const NodeID &
 
   // face1 = getFaceById_(1);
 
+  /* Sample queue depths, store sizes and counters periodically */
+  AddMetricGauges();
+  if (metrics::MetricsExporter::Instance().Enabled())
+    SampleMetrics();
+
   /* Initiate event scheduling */
   /* 2s: Start simulation */
-  scheduler_.scheduleEvent(time::milliseconds(2000), [this] { StartSimulation(); });
+  start_event = scheduler_.scheduleEvent(time::milliseconds(2000), [this] { StartSimulation(); });
 
   /* 400s: Stop data generation */
   scheduler_.scheduleEvent(time::seconds(800), [this] {
     generate_data = false;
   });
 
-  /* 1195s: Print NFD statistics */
-  scheduler_.scheduleEvent(time::seconds(2395), [this] {
-    // Repo nodes are also used to calculate collision rates
-    std::cout << "node(" << nid_ << ") should_receive_sync_interest = " << should_receive_sync_interest << std::endl;
-    std::cout << "node(" << nid_ << ") received_sync_interest = " << received_sync_interest << std::endl;
-
-    if (!is_static) {
-      std::cout << "node(" << nid_ << ") suppressed_sync_interest = " << suppressed_sync_interest << std::endl;
-      std::cout << "node(" << nid_ << ") data_reply = " << data_reply << std::endl;
-      std::cout << "node(" << nid_ << ") received_data_interest = " << received_data_interest << std::endl;
-      std::cout << "node(" << nid_ << ") received_data_mobile = " << received_data_mobile << std::endl;
-      std::cout << "node(" << nid_ << ") received_data_mobile_from_repo = " << received_data_mobile_from_repo << std::endl;
-
-      if (is_hibernate)
-        hibernate_duration += ns3::Simulator::Now().GetMicroSeconds() - hibernate_start;
-      std::cout << "node(" << nid_ << ") hibernate_duration = " << (float)hibernate_duration / 1000000 << std::endl;
-      PrintNDNTraffic();
-    }
-  });
+  /* 1195s: Print NFD and Node statistics */
+  scheduler_.scheduleEvent(time::seconds(2395), [this] { PrintStatistics(); });
+}
 
-  /* 1196s: Print Node statistics */
-  scheduler_.scheduleEvent(time::seconds(2396), [this] {
-    uint64_t seq_sum = 0;
-    for (auto entry: version_vector_) {
-      seq_sum += entry.second;
-    }
-    std::cout << "node(" << nid_ << ") seq sum: " << seq_sum << std::endl;
-    // std::cout << "node(" << nid_ << ") seq = " << version_vector_[nid_] << std::endl;
-  });
+void Node::PrintStatistics() {
+  // Repo nodes are also used to calculate collision rates
+  std::cout << "node(" << nid_ << ") should_receive_sync_interest = " << should_receive_sync_interest << std::endl;
+  std::cout << "node(" << nid_ << ") received_sync_interest = " << received_sync_interest << std::endl;
+
+  if (!is_static) {
+    std::cout << "node(" << nid_ << ") suppressed_sync_interest = " << suppressed_sync_interest << std::endl;
+    std::cout << "node(" << nid_ << ") data_reply = " << data_reply << std::endl;
+    std::cout << "node(" << nid_ << ") received_data_interest = " << received_data_interest << std::endl;
+    std::cout << "node(" << nid_ << ") received_data_mobile = " << received_data_mobile << std::endl;
+    std::cout << "node(" << nid_ << ") received_data_mobile_from_repo = " << received_data_mobile_from_repo << std::endl;
+
+    std::cout << "node(" << nid_ << ") hibernate_duration = " << (float)HibernateDuration() / 1000000 << std::endl;
+    PrintNDNTraffic();
+  }
+  PrintQueueStats();
+  const auto& store_stats = data_store_.GetStats();
+  std::cout << "node(" << nid_ << ") data_store: size = " << data_store_.size()
+            << ", bytes = " << data_store_.Bytes()
+            << ", hits = " << store_stats.hits
+            << ", misses = " << store_stats.misses
+            << ", evictions = " << store_stats.evictions << std::endl;
+
+  std::cout << "node(" << nid_ << ") seq sum: " << version_vector_.Sum() << std::endl;
+  // std::cout << "node(" << nid_ << ") seq = " << version_vector_[nid_] << std::endl;
 }
 
 void Node::PublishData(const std::string& content, uint32_t type) {
@@ -125,30 +168,34 @@ void Node::PublishData(const std::string& content, uint32_t type) {
   version_vector_data_[nid_]++;
 
   /* Make data name */
-  auto n = MakeDataName(nid_, version_vector_[nid_]);
+  auto n = MakeDataName(nid_, version_vector_.Get(nid_));
   std::shared_ptr<Data> data = std::make_shared<Data>(n);
   data->setFreshnessPeriod(time::seconds(3600));
   /* Set data content */
   proto::Content content_proto;
-  // EncodeVV(version_vector_, content_proto.mutable_vv());
-  EncodeVVWithInterest(version_vector_, content_proto.mutable_vv(), is_important_data_, surrounding_producers);
+  content_proto.set_vv(EncodedVV());
   content_proto.set_content(content);
+  content_proto.set_timestamp(ns3::Simulator::Now().GetMicroSeconds());
   const std::string& content_proto_str = content_proto.SerializeAsString();
   data -> setContent(reinterpret_cast<const uint8_t*>(content_proto_str.data()),
                    content_proto_str.size());
   data -> setContentType(type);
   key_chain_.sign(*data, signingWithSha256());
 
-  data_store_[n] = data;
+  data_store_.Insert(nid_, version_vector_.Get(nid_), data);
 
   /* Print that both state and data have been stored */
   logger.logDataStore(n);
-  logger.logStateStore(nid_, version_vector_[nid_]);
+  logger.logStateStore(nid_, version_vector_.Get(nid_));
+  if (on_data_store_)
+    on_data_store_(nid_, version_vector_.Get(nid_), version_vector_.Get(nid_));
+  if (on_state_store_)
+    on_state_store_(nid_, version_vector_.Get(nid_), version_vector_.Get(nid_));
   VSYNC_LOG_TRACE( "node(" << nid_ << ") Publish Data: d.name=" << n.toUri() );
 
   /* Schedule next publish with same data */
   if (generate_data) {
-    scheduler_.scheduleEvent(time::milliseconds(data_generation_dist(rengine_)),
+    scheduler_.scheduleEvent(time::milliseconds(data_generation_dist(data_generation_rng_)),
                              [this, content] { PublishData(content); });
   } else {
     VSYNC_LOG_TRACE( "node(" << nid_ << ") Stopped data generation");
@@ -177,7 +224,7 @@ void Node::StartSimulation() {
   odometer.init();
 
   if (kRetx) {
-    int delay = retx_dist(rengine_);
+    int delay = retx_dist(retx_rng_);
     retx_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
       RetxSyncInterest();
       VSYNC_LOG_TRACE( "node(" << nid_ << ") Retx sync interest" );
@@ -185,6 +232,342 @@ void Node::StartSimulation() {
   }
 }
 
+/**
+ * Save what the node would need to continue: vectors, data store, queues,
+ *  missing data, soft state, counters and random streams. Data interests in
+ *  flight, i.e. waiting for a scheduler retx or sent as part of a bundle, are
+ *  saved as missing and asked for again after a restore. Pending timers are
+ *  not saved but re-armed by the restore.
+ */
+void Node::SaveSnapshot(proto::NodeSnapshot& snapshot) const {
+  auto save_vv = [] (const VersionVector& vv,
+                     google::protobuf::RepeatedPtrField<proto::NodeSnapshot::Seq>* out) {
+    for (auto entry : vv) {
+      auto seq = out->Add();
+      seq->set_nid(entry.first);
+      seq->set_seq(entry.second);
+    }
+  };
+  snapshot.set_nid(nid_);
+  snapshot.set_time(ns3::Simulator::Now().GetMicroSeconds());
+  save_vv(version_vector_, snapshot.mutable_version_vector());
+  save_vv(version_vector_data_, snapshot.mutable_version_vector_data());
+  save_vv(pending_sync_vv_, snapshot.mutable_pending_sync_vv());
+  save_vv(last_sent_vv_, snapshot.mutable_last_sent_vv());
+
+  data_store_.ForEach([&snapshot] (NodeID, uint64_t, const std::shared_ptr<const Data>& data) {
+    const Block& wire = data->wireEncode();
+    snapshot.add_data(wire.wire(), wire.size());
+  });
+  const auto& store_stats = data_store_.GetStats();
+  snapshot.set_store_hits(store_stats.hits);
+  snapshot.set_store_misses(store_stats.misses);
+  snapshot.set_store_insertions(store_stats.insertions);
+  snapshot.set_store_evictions(store_stats.evictions);
+
+  for (size_t i = 0; i < SendQueue::kNumTypes; ++i) {
+    auto type = static_cast<SendQueue::Type>(i);
+    for (const auto& packet : send_queue_.Queue(type)) {
+      auto saved = snapshot.add_packet();
+      saved->set_queue(type);
+      if (packet.packet_type == Packet::INTEREST_TYPE) {
+        const Block& wire = packet.interest->wireEncode();
+        saved->set_interest(wire.wire(), wire.size());
+        saved->set_origin(packet.packet_origin);
+      } else {
+        const Block& wire = packet.data->wireEncode();
+        saved->set_data(wire.wire(), wire.size());
+      }
+      saved->set_last_sent_time(packet.last_sent_time);
+      saved->set_inf_retx_start_time(packet.inf_retx_start_time);
+      saved->set_enqueue_time(packet.enqueue_time);
+      saved->set_last_sent_dist(packet.last_sent_dist);
+      saved->set_n_retries(packet.nRetries);
+      saved->set_retransmission_counter(packet.retransmission_counter);
+      saved->set_burst_packet(packet.burst_packet);
+    }
+    const auto& stats = send_queue_.GetStats(type);
+    auto saved_stats = snapshot.add_queue_stats();
+    saved_stats->set_enqueued(stats.enqueued);
+    saved_stats->set_dequeued(stats.dequeued);
+    saved_stats->set_dropped(stats.dropped);
+    saved_stats->set_max_depth(stats.max_depth);
+    saved_stats->set_total_wait(stats.total_wait);
+  }
+
+  /**
+   * Interested data neither stored, missing nor queued is in flight. With a
+   *  memory budget it may have been evicted instead, so only data waiting
+   *  for a scheduler retx is known to be in flight.
+   */
+  MissingDataTracker missing = missing_data_;
+  unbundled_data_.ForEachRange([&missing] (NodeID node_id, uint64_t first, uint64_t last) {
+    missing.Insert(node_id, first, last);
+  });
+  if (kDataStoreBudget == 0) {
+    for (auto entry : version_vector_data_) {
+      if (entry.first == nid_ || !is_important_data_(entry.first))
+        continue;
+      for (uint64_t seq = 1; seq <= entry.second; ++seq) {
+        if (data_store_.Contains(entry.first, seq) || missing.Contains(entry.first, seq))
+          continue;
+        auto n = MakeDataName(entry.first, seq);
+        if (!send_queue_.Contains(SendQueue::kDataInterest, n) &&
+            !send_queue_.Contains(SendQueue::kInfRetxDataInterest, n))
+          missing.Insert(entry.first, seq, seq);
+      }
+    }
+  } else {
+    for (const auto& n : retx_in_flight_)
+      missing.Insert(ExtractNodeID(n), ExtractSequence(n), ExtractSequence(n));
+  }
+  missing.ForEachRange([&snapshot] (NodeID node_id, uint64_t first, uint64_t last) {
+    auto range = snapshot.add_missing();
+    range->set_nid(node_id);
+    range->set_first(first);
+    range->set_last(last);
+  });
+  for (const auto& n : inf_retx_age_) {
+    if (send_queue_.Contains(SendQueue::kInfRetxDataInterest, n))
+      snapshot.add_inf_retx(n.toUri());
+  }
+
+  for (const auto& neighbor : one_hop)
+    snapshot.add_one_hop(neighbor.first);
+  for (const auto& producer : surrounding_producers)
+    snapshot.add_surrounding_producer(producer.first);
+  for (const auto& counter : metrics_.Counters()) {
+    auto saved = snapshot.add_counter();
+    saved->set_name(counter.first);
+    saved->set_value(counter.second.Value());
+  }
+  /* In RandomStream::Purpose order */
+  for (const RandomStream* stream : {&data_generation_rng_, &packet_rng_, &retx_rng_,
+                                     &ack_rng_, &mhop_rng_})
+    snapshot.add_random_stream(stream->Save());
+
+  snapshot.set_generate_data(generate_data);
+  snapshot.set_is_hibernate(is_hibernate);
+  snapshot.set_hibernate_start(hibernate_start);
+  snapshot.set_hibernate_duration(hibernate_duration);
+  snapshot.set_rounds_since_full_vv(rounds_since_full_vv_);
+}
+
+bool Node::LoadSnapshot(const proto::NodeSnapshot& snapshot) {
+  int64_t delay = snapshot.time() - ns3::Simulator::Now().GetMicroSeconds();
+  if (snapshot.nid() != nid_ || delay < 0 || snapshot.random_stream_size() != int(RandomStream::kNumPurposes))
+    return false;
+  for (const auto& state : snapshot.random_stream()) {
+    if (!RandomStream(0).Restore(state))
+      return false;
+  }
+  auto saved = std::make_shared<proto::NodeSnapshot>(snapshot);
+  scheduler_.cancelEvent(start_event);
+  start_event = scheduler_.scheduleEvent(time::microseconds(delay), [this, saved] {
+    RestoreSnapshot(*saved);
+  });
+  return true;
+}
+
+/**
+ * Continue from a snapshot taken at the current time. Stores are reported to
+ *  the OnStore callbacks but not logged, so the event log only covers what
+ *  happens after the checkpoint.
+ */
+void Node::RestoreSnapshot(const proto::NodeSnapshot& snapshot) {
+  auto load_vv = [] (const google::protobuf::RepeatedPtrField<proto::NodeSnapshot::Seq>& in,
+                     VersionVector& vv) {
+    vv.Clear();
+    for (const auto& entry : in)
+      vv.Set(entry.nid(), entry.seq());
+  };
+  load_vv(snapshot.version_vector(), version_vector_);
+  load_vv(snapshot.version_vector_data(), version_vector_data_);
+  load_vv(snapshot.pending_sync_vv(), pending_sync_vv_);
+  load_vv(snapshot.last_sent_vv(), last_sent_vv_);
+  if (on_state_store_) {
+    for (auto entry : version_vector_) {
+      if (entry.second > 0)
+        on_state_store_(entry.first, 1, entry.second);
+    }
+  }
+
+  for (const auto& wire : snapshot.data()) {
+    std::shared_ptr<Data> data;
+    try {
+      data = std::make_shared<Data>(Block(reinterpret_cast<const uint8_t*>(wire.data()), wire.size()));
+    } catch (const tlv::Error&) {
+      VSYNC_LOG_WARN( "node(" << nid_ << ") Malformed data in snapshot" );
+      continue;
+    }
+    data_store_.Insert(data->getName(), data);
+    if (on_data_store_)
+      on_data_store_(ExtractNodeID(data->getName()), ExtractSequence(data->getName()),
+                     ExtractSequence(data->getName()));
+  }
+  data_store_.SetStats(DataStore::Stats{snapshot.store_hits(), snapshot.store_misses(),
+                                        snapshot.store_insertions(), snapshot.store_evictions()});
+
+  pending_forward = 0;
+  for (const auto& saved : snapshot.packet()) {
+    if (saved.queue() >= SendQueue::kNumTypes)
+      continue;
+    Packet packet;
+    try {
+      if (!saved.interest().empty()) {
+        packet.packet_type = Packet::INTEREST_TYPE;
+        packet.interest = std::make_shared<Interest>(Block(
+          reinterpret_cast<const uint8_t*>(saved.interest().data()), saved.interest().size()));
+      } else {
+        packet.packet_type = Packet::DATA_TYPE;
+        packet.data = std::make_shared<Data>(Block(
+          reinterpret_cast<const uint8_t*>(saved.data().data()), saved.data().size()));
+      }
+    } catch (const tlv::Error&) {
+      VSYNC_LOG_WARN( "node(" << nid_ << ") Malformed packet in snapshot" );
+      continue;
+    }
+    packet.packet_origin = static_cast<Packet::SourceType>(saved.origin());
+    packet.last_sent_time = saved.last_sent_time();
+    packet.inf_retx_start_time = saved.inf_retx_start_time();
+    packet.enqueue_time = saved.enqueue_time();
+    packet.last_sent_dist = saved.last_sent_dist();
+    packet.nRetries = saved.n_retries();
+    packet.retransmission_counter = saved.retransmission_counter();
+    packet.burst_packet = saved.burst_packet();
+    if (packet.packet_type == Packet::INTEREST_TYPE && packet.packet_origin == Packet::FORWARDED)
+      pending_forward++;
+    send_queue_.Restore(static_cast<SendQueue::Type>(saved.queue()), packet);
+  }
+  for (int i = 0; i < snapshot.queue_stats_size() && i < int(SendQueue::kNumTypes); ++i) {
+    const auto& saved = snapshot.queue_stats(i);
+    send_queue_.SetStats(static_cast<SendQueue::Type>(i),
+                         SendQueue::Stats{saved.enqueued(), saved.dequeued(), saved.dropped(),
+                                          saved.max_depth(), saved.total_wait()});
+  }
+
+  for (const auto& range : snapshot.missing())
+    missing_data_.Insert(range.nid(), range.first(), range.last());
+  for (const auto& uri : snapshot.inf_retx()) {
+    Name n(uri);
+    inf_retx_age_.push_back(n);
+    inf_retx_age_index_[n] = std::prev(inf_retx_age_.end());
+  }
+
+  /* Soft state starts over with full timeouts */
+  for (NodeID sender_id : snapshot.one_hop()) {
+    one_hop[sender_id] = scheduler_.scheduleEvent(kNeighborTimeout, [this, sender_id] {
+      one_hop.erase(sender_id);
+    });
+  }
+  for (NodeID producer : snapshot.surrounding_producer()) {
+    surrounding_producers[producer] = scheduler_.scheduleEvent(time::seconds(1), [this, producer] {
+      surrounding_producers.erase(producer);
+    });
+  }
+  for (const auto& counter : snapshot.counter())
+    metrics_.GetCounter(counter.name()).Set(counter.value());
+  int purpose = 0;
+  for (RandomStream* stream : {&data_generation_rng_, &packet_rng_, &retx_rng_,
+                               &ack_rng_, &mhop_rng_})
+    stream->Restore(snapshot.random_stream(purpose++));
+
+  generate_data = snapshot.generate_data();
+  hibernate_start = snapshot.hibernate_start();
+  hibernate_duration = snapshot.hibernate_duration();
+  rounds_since_full_vv_ = snapshot.rounds_since_full_vv();
+  force_full_vv_ = true;
+  encoded_vv_valid_ = false;
+  VSYNC_LOG_TRACE( "node(" << nid_ << ") Restored snapshot: data = " << data_store_.size()
+                   << ", missing = " << missing_data_.size() );
+
+  /* Re-arm timers as StartSimulation() does */
+  if (generate_data) {
+    std::string content = std::string(100, '*');
+    scheduler_.scheduleEvent(time::milliseconds(data_generation_dist(data_generation_rng_)),
+                             [this, content] { PublishData(content); });
+  }
+  is_hibernate = snapshot.is_hibernate();
+  int delay = is_hibernate ? hibernate_packet_dist_(packet_rng_) : packet_dist(packet_rng_);
+  scheduler_.cancelEvent(packet_event);
+  packet_event = scheduler_.scheduleEvent(time::microseconds(delay),
+                                          [this] { AsyncSendPacket(); });
+  if (!is_hibernate)
+    refreshHibernateTimer();
+  odometer.init();
+  if (kRetx) {
+    delay = retx_dist(retx_rng_);
+    retx_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
+      RetxSyncInterest();
+      VSYNC_LOG_TRACE( "node(" << nid_ << ") Retx sync interest" );
+    });
+  }
+}
+
+void Node::AddMetricGauges() {
+  for (size_t i = 0; i < SendQueue::kNumTypes; ++i) {
+    auto type = static_cast<SendQueue::Type>(i);
+    std::string name = std::string("queue.") + SendQueue::TypeName(type);
+    metrics_.AddGauge(name + ".depth", [this, type] { return send_queue_.Size(type); });
+    metrics_.AddGauge(name + ".enqueued",
+                      [this, type] { return send_queue_.GetStats(type).enqueued; });
+    metrics_.AddGauge(name + ".dropped",
+                      [this, type] { return send_queue_.GetStats(type).dropped; });
+  }
+  metrics_.AddGauge("missing_data", [this] {
+    return missing_data_.size() + unbundled_data_.size();
+  });
+  metrics_.AddGauge("inf_retx", [this] { return inf_retx_age_.size(); });
+  metrics_.AddGauge("data_store.size", [this] { return data_store_.size(); });
+  metrics_.AddGauge("data_store.bytes", [this] { return data_store_.Bytes(); });
+  metrics_.AddGauge("data_store.slots", [this] { return data_store_.Slots(); });
+  metrics_.AddGauge("data_store.hits", [this] { return data_store_.GetStats().hits; });
+  metrics_.AddGauge("data_store.misses", [this] { return data_store_.GetStats().misses; });
+  metrics_.AddGauge("data_store.evictions",
+                    [this] { return data_store_.GetStats().evictions; });
+  metrics_.AddGauge("seq_sum", [this] { return version_vector_.Sum(); });
+  metrics_.AddGauge("hibernate", [this] { return is_hibernate ? 1 : 0; });
+  metrics_.AddGauge("hibernate_duration_s", [this] { return HibernateDuration() / 1000000.0; });
+}
+
+int64_t Node::HibernateDuration() const {
+  int64_t duration = hibernate_duration;
+  if (is_hibernate)
+    duration += ns3::Simulator::Now().GetMicroSeconds() - hibernate_start;
+  return duration;
+}
+
+void Node::SampleMetrics() {
+  metrics_.Sample(ns3::Simulator::Now().GetMicroSeconds());
+  auto interval = metrics::MetricsExporter::Instance().IntervalMs();
+  scheduler_.scheduleEvent(time::milliseconds(interval), [this] { SampleMetrics(); });
+}
+
+/**
+ * Record the time from publish to store of a data, overall and by the path
+ *  that delivered it: a repo, or the original, forwarded or suppressed reply.
+ */
+void Node::RecordSyncLatency(const Data& data, Packet::SourceType sourceType) {
+  proto::Content content_proto;
+  if (!content_proto.ParseFromArray(data.getContent().value(), data.getContent().value_size()) ||
+      content_proto.timestamp() == 0)
+    return;
+  double latency = (ns3::Simulator::Now().GetMicroSeconds() - content_proto.timestamp()) / 1000.0;
+
+  const char* source = nullptr;
+  if (data.getContentType() == kRepoData)
+    source = "repo";
+  else if (sourceType == Packet::ORIGINAL)
+    source = "original";
+  else if (sourceType == Packet::FORWARDED)
+    source = "forwarded";
+  else
+    source = "suppressed";
+  metrics_.GetHistogram("sync_latency_ms", kSyncLatencyBounds).Record(latency);
+  metrics_.GetHistogram(std::string("sync_latency_ms.") + source, kSyncLatencyBounds)
+    .Record(latency);
+}
+
 void Node::PrintNDNTraffic() {
   /* Send a packet to trigger NFD to print */
   Interest i(kGetNDNTraffic, time::milliseconds(5));
@@ -194,95 +577,196 @@ void Node::PrintNDNTraffic() {
 }
 
 /**
- * Remove the oldest packet in the inf retx data interest queue
+ * Remove the oldest interest in inf retx, whether it is queued or waiting in
+ *  the scheduler. Interests enter inf retx in time order, so this is the head
+ *  of inf_retx_age_.
  */
 void Node::RemoveOldestInfInterest() {
-  int64_t oldest_timestamp_ms = INT64_MAX;
-  std::deque<Packet>::iterator oldest_packet;
-  std::deque<Packet>::iterator it = inf_retx_data_interest.begin();
-
-  while (it != inf_retx_data_interest.end()) {
-    if (it->inf_retx_start_time < oldest_timestamp_ms) {
-      oldest_timestamp_ms = it->inf_retx_start_time;
-      oldest_packet = it;
-    }
-    it++;
-  }
-  inf_retx_data_interest.erase(oldest_packet);
+  if (inf_retx_age_.empty())
+    return;
+  Name oldest = inf_retx_age_.front();
+  RemoveDataInterest(oldest);
   VSYNC_LOG_TRACE( "node(" << nid_ << ") Removed an oldest interest from inf retx queue" );
 }
 
 /**
- * Given the type of packet, return the queue that the packet should be inserted into.
+ * Move a data interest that ran out of retries into the inf retx queue,
+ *  evicting the oldest ones beyond kInfRetxNum.
  */
-std::deque<Packet>& Node::GetQueueByType(const std::string &type) {
-  if (type == "SYNC_INTEREST")
-    return pending_sync_interest;
-  else if (type == "SYNC_REPLY")
-    return pending_ack;
-  else if (type == "DATA_INTEREST")
-    return pending_data_interest;
-  else if (type == "DATA_REPLY")
-    return pending_data_reply;
-  else if (type == "INF_RETX_DATA_INTEREST")
-    return inf_retx_data_interest;
-  else
-    exit(1);
-    // You shouldn't reach here.
+void Node::AddInfRetxInterest(Packet packet) {
+  const Name& n = packet.interest->getName();
+  packet.inf_retx_start_time = ns3::Simulator::Now().GetMicroSeconds();
+  if (inf_retx_age_index_.count(n) == 0) {
+    inf_retx_age_.push_back(n);
+    inf_retx_age_index_[n] = std::prev(inf_retx_age_.end());
+  }
+  Enqueue(SendQueue::kInfRetxDataInterest, packet);
+  while (inf_retx_age_.size() > uint32_t(kInfRetxNum))
+    RemoveOldestInfInterest();
+}
+
+/**
+ * Whether data n is missing, or its original data interest is queued or
+ *  waiting for retx.
+ */
+bool Node::HasDataInterest(const Name& n) const {
+  return missing_data_.Contains(ExtractNodeID(n), ExtractSequence(n)) ||
+         unbundled_data_.Contains(ExtractNodeID(n), ExtractSequence(n)) ||
+         send_queue_.Contains(SendQueue::kDataInterest, n) ||
+         send_queue_.Contains(SendQueue::kInfRetxDataInterest, n) ||
+         retx_in_flight_.count(n) > 0;
+}
+
+/**
+ * Drop every trace of the original data interest for n, e.g. when its data
+ *  arrives. A pending scheduler retx will find it gone and not re-queue it.
+ */
+void Node::RemoveDataInterest(const Name& n) {
+  NodeID node_id = ExtractNodeID(n);
+  uint64_t seq = ExtractSequence(n);
+  missing_data_.Erase(node_id, seq);
+  unbundled_data_.Erase(node_id, seq);
+  auto attempts = bundle_attempts_.find(node_id);
+  if (attempts != bundle_attempts_.end()) {
+    attempts->second.erase(seq);
+    if (attempts->second.empty())
+      bundle_attempts_.erase(attempts);
+  }
+  send_queue_.Erase(SendQueue::kDataInterest, n);
+  send_queue_.Erase(SendQueue::kInfRetxDataInterest, n);
+  retx_in_flight_.erase(n);
+  auto it = inf_retx_age_index_.find(n);
+  if (it != inf_retx_age_index_.end()) {
+    inf_retx_age_.erase(it->second);
+    inf_retx_age_index_.erase(it);
+  }
+}
+
+/**
+ * Encoded version_vector_, re-encoded only when the vector has changed since
+ *  the last call. is_important_data_ is fixed for the node's lifetime.
+ */
+const std::string& Node::EncodedVV() {
+  if (!encoded_vv_valid_ || encoded_vv_version_ != version_vector_.Version()) {
+    encoded_vv_.clear();
+    EncodeVVWithInterest(version_vector_, is_important_data_, encoded_vv_);
+    encoded_vv_version_ = version_vector_.Version();
+    encoded_vv_valid_ = true;
+  }
+  return encoded_vv_;
+}
+
+void Node::Enqueue(SendQueue::Type type, const Packet& packet) {
+  send_queue_.Push(type, packet, ns3::Simulator::Now().GetMicroSeconds());
+}
+
+void Node::PrintQueueStats() {
+  for (size_t i = 0; i < SendQueue::kNumTypes; ++i) {
+    auto type = static_cast<SendQueue::Type>(i);
+    const auto& stats = send_queue_.GetStats(type);
+    std::cout << "node(" << nid_ << ") queue " << SendQueue::TypeName(type)
+              << ": enqueued = " << stats.enqueued
+              << ", dropped = " << stats.dropped
+              << ", max_depth = " << stats.max_depth
+              << ", avg_wait = "
+              << (stats.dequeued ? (float)stats.total_wait / stats.dequeued / 1000000 : 0)
+              << std::endl;
+  }
+}
+
+/**
+ * Merge a received state vector into both local vectors: log newly learned
+ *  states, and record every newly learned gap of interested data as missing.
+ * Return true if the received vector has data not yet added to the queue.
+ */
+bool Node::MergeStateVector(const VersionVector& other_vv) {
+  version_vector_.Merge(other_vv, [this] (NodeID node_id, uint64_t from, uint64_t to) {
+    logger.logStateStore(node_id, from + 1, to);
+    if (on_state_store_)
+      on_state_store_(node_id, from + 1, to);
+  });
+
+  return version_vector_data_.Merge(other_vv,
+    [this] (NodeID node_id, uint64_t from, uint64_t to) {
+      if (is_important_data_(node_id) == false)  // Partial sync, skip data not interested
+        return;
+      missing_data_.Insert(node_id, from + 1, to);
+    });
+}
+
+/**
+ * Materialize data interests for missing data, keeping at most
+ *  kDataInterestWindow of them in the data interest queue. Runs of more than
+ *  kMissingDataThreshold missing seqs are asked for with one bundled interest,
+ *  seqs of bundles that kept failing with single ones first.
+ */
+void Node::FillDataInterestQueue() {
+  NodeID node_id;
+  uint64_t seq, last;
+  while (kBundledData &&
+         send_queue_.Size(SendQueue::kDataInterest) < size_t(kDataInterestWindow) &&
+         missing_data_.NextRange(kMissingDataThreshold, kMaxBundleLength, node_id, seq, last)) {
+    auto n = MakeBundledDataName(node_id, seq, last, ns3::Simulator::Now().GetMicroSeconds());
+    Packet packet;
+    packet.packet_type = Packet::INTEREST_TYPE;
+    packet.packet_origin = Packet::ORIGINAL;
+    packet.last_sent_time = 0;
+    packet.last_sent_dist = 0;
+    packet.nRetries = 0;
+    packet.interest = std::make_shared<Interest>(n, kSendOutInterestLifetime);
+    Enqueue(SendQueue::kDataInterest, packet);
+  }
+  while (send_queue_.Size(SendQueue::kDataInterest) < size_t(kDataInterestWindow) &&
+         (unbundled_data_.Next(node_id, seq) || missing_data_.Next(node_id, seq))) {
+    auto n = MakeDataName(node_id, seq);
+    if (HasDataInterest(n) || data_store_.WasStored(node_id, seq))
+      continue;
+    Packet packet;
+    packet.packet_type = Packet::INTEREST_TYPE;
+    packet.packet_origin = Packet::ORIGINAL;
+    packet.last_sent_time = 0;
+    packet.last_sent_dist = 0;
+    packet.nRetries = kDataInterestRetries;
+    packet.interest = std::make_shared<Interest>(n, kSendOutInterestLifetime);
+    Enqueue(SendQueue::kDataInterest, packet);
+  }
 }
 
 void Node::AsyncSendPacket() {
   if (is_hibernate)
     SendSyncInterest();
 
-  if (pending_sync_interest.size() > 0 ||
-      pending_data_interest.size() > 0 ||
-      pending_ack.size() > 0 ||
-      pending_data_reply.size() > 0 || 
-      inf_retx_data_interest.size() > 0) {
-
-    /* Select the highest priority packet */
-    Name n;
-    Packet packet;
-    bool is_inf_retx = false;
-    if (pending_ack.size() > 0) {
-      packet = pending_ack.front();
-      pending_ack.pop_front();
-      // pending_ack.clear();
-    } else if (pending_data_reply.size() > 0) {
-      packet = pending_data_reply.front();
-      pending_data_reply.pop_front();
-    } else if (pending_sync_interest.size() > 0) {
-      packet = pending_sync_interest.front();
-      pending_sync_interest.pop_front();
-    } else if (pending_data_interest.size() > 0) {
-      packet = pending_data_interest.front();
-      pending_data_interest.pop_front();
-    } else {
-      packet = inf_retx_data_interest.front();
-      inf_retx_data_interest.pop_front();
-      is_inf_retx = true;
+  /**
+   * Select the next packet according to queue scheduling. Original data
+   *  interests are removed from the queues when their data arrives, but
+   *  forwarded ones may still turn out falsy; skip those.
+   */
+  FillDataInterestQueue();
+  Name n;
+  Packet packet;
+  SendQueue::Type type;
+  bool has_packet = false;
+  while (send_queue_.Pop(ns3::Simulator::Now().GetMicroSeconds(), packet, type)) {
+    if (packet.packet_type == Packet::INTEREST_TYPE &&
+        packet.interest->getName().compare(0, 2, kSyncDataPrefix) == 0 &&
+        data_store_.Contains(packet.interest->getName())) {
+      VSYNC_LOG_TRACE ("node(" << nid_ << ") Drop falsy data interest: i.name="
+                       << packet.interest->getName().toUri() );
+      if (packet.packet_origin == Packet::FORWARDED)
+        pending_forward--;
+      continue;
     }
+    has_packet = true;
+    break;
+  }
+
+  if (has_packet) {
+    bool is_inf_retx = (type == SendQueue::kInfRetxDataInterest);
     switch (packet.packet_type) {
 
       case Packet::INTEREST_TYPE:
         n = (packet.interest)->getName();
         if (n.compare(0, 2, kSyncDataPrefix) == 0) {            /* Data interest */
-          /* Remove falsy data interest */
-          if (data_store_.find(n) != data_store_.end()) {
-            VSYNC_LOG_TRACE ("node(" << nid_ << ") Drop falsy data interest: i.name=" << n.toUri() );
-
-            if (packet.packet_origin == Packet::FORWARDED)
-              pending_forward--;
-            VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length: " <<
-                pending_data_interest.size() + inf_retx_data_interest.size() + 
-                num_scheduler_retx - pending_forward );
-            VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length inf: " <<
-                             inf_retx_data_interest.size() + num_scheduler_retx_inf);
-            AsyncSendPacket();
-            return;
-          }
-
           // If the node didn't travel far since last time sending this packet, put
           //  this data packet back into the queue, and send the next packet immediately.
           // To prevent iterating the queue too fast, need to add some delay.
@@ -292,9 +776,9 @@ void Node::AsyncSendPacket() {
           //   VSYNC_LOG_TRACE ("node(" << nid_ << ") Cancel data interest due to dist");
           //   scheduler_.scheduleEvent(time::seconds(1), [this, packet, is_inf_retx] {
           //     if (is_inf_retx)
-          //       GetQueueByType("INF_RETX_DATA_INTEREST").push_back(packet);
+          //       Enqueue(SendQueue::kInfRetxDataInterest, packet);
           //     else
-          //       GetQueueByType("DATA_INTEREST").push_back(packet);
+          //       Enqueue(SendQueue::kDataInterest, packet);
           //   });
           //   AsyncSendPacket();
           //   return;
@@ -318,39 +802,37 @@ void Node::AsyncSendPacket() {
                 packet.last_sent_dist = odometer.getDist();
                 packet.retransmission_counter ++;
 
+                /* Not re-queued if data arrives or it gets evicted meanwhile */
+                retx_in_flight_.insert(n);
                 if (is_inf_retx) {
                   scheduler_.scheduleEvent(kInfRetxDataInterestTime, [this, packet] {
-                    // inf_retx_data_interest.push_back(packet);
-                    GetQueueByType("INF_RETX_DATA_INTEREST").push_back(packet);
                     num_scheduler_retx--;
                     num_scheduler_retx_inf--;
+                    if (retx_in_flight_.erase(packet.interest->getName()) > 0)
+                      Enqueue(SendQueue::kInfRetxDataInterest, packet);
                   });
                 }
                 // else if (packet.nRetries % 3 == 0) {
                 else if (1) {
                   packet.burst_packet = false;
                   scheduler_.scheduleEvent(kRetxDataInterestTime, [this, packet] {
-                    // pending_data_interest.push_back(packet);
-                    GetQueueByType("DATA_INTEREST").push_back(packet);
                     num_scheduler_retx--;
+                    if (retx_in_flight_.erase(packet.interest->getName()) > 0)
+                      Enqueue(SendQueue::kDataInterest, packet);
                   });
                 } 
                 else {
                   packet.burst_packet = true;
                   scheduler_.scheduleEvent(kSendOutInterestLifetime, [this, packet] {
-                    // pending_data_interest.push_back(packet);
-                    GetQueueByType("DATA_INTEREST").push_back(packet);
                     num_scheduler_retx--;
+                    if (retx_in_flight_.erase(packet.interest->getName()) > 0)
+                      Enqueue(SendQueue::kDataInterest, packet);
                   });
                 }
               } else {
                 // VSYNC_LOG_TRACE("DROP INTEREST");
                 VSYNC_LOG_TRACE("APPEND INTEREST TO INF RETX QUEUE");
-                packet.inf_retx_start_time = ns3::Simulator::Now().GetMicroSeconds();
-                // inf_retx_data_interest.push_back(packet);
-                GetQueueByType("INF_RETX_DATA_INTEREST").push_back(packet);
-                while (inf_retx_data_interest.size() > uint32_t(kInfRetxNum))
-                  RemoveOldestInfInterest();
+                AddInfRetxInterest(packet);
               }
               break;
             case Packet::FORWARDED:
@@ -368,11 +850,20 @@ void Node::AsyncSendPacket() {
                                 std::bind(&Node::OnSyncAck, this, _2),
                                 [](const Interest&, const lp::Nack&) {},
                                 [](const Interest&) {});
+          last_sent_vv_ = pending_sync_vv_;
           int num_surrounding = getNumSurroundingNodes_();
           VSYNC_LOG_TRACE ("node(" << nid_ << ") Send Sync Interest: i.name=" << n.toUri()
                            << ", should be received by " << num_surrounding );
           should_receive_sync_interest += num_surrounding;
         }
+        else if (n.compare(0, 2, kBundledDataPrefix) == 0) {  /* Bundled data interest */
+          face_.expressInterest(*packet.interest,
+                                std::bind(&Node::OnBundledData, this, _1, _2),
+                                std::bind(&Node::OnBundledDataTimeout, this, _1),
+                                std::bind(&Node::OnBundledDataTimeout, this, _1));
+          VSYNC_LOG_TRACE ("node(" << nid_ << ") Send Bundled Data Interest: i.name=" << n.toUri()
+                           << ", should be received by " << getNumSurroundingNodes_() );
+        }
         break;
 
       case Packet::DATA_TYPE:
@@ -397,9 +888,9 @@ void Node::AsyncSendPacket() {
   /* Schedule self */
   int delay;
   if (!is_hibernate)
-    delay = packet_dist(rengine_);
+    delay = packet_dist(packet_rng_);
   else
-    delay = hibernate_packet_dist_(rengine_);
+    delay = hibernate_packet_dist_(packet_rng_);
   scheduler_.cancelEvent(packet_event);
   packet_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
     AsyncSendPacket();
@@ -410,26 +901,63 @@ void Node::AsyncSendPacket() {
 /* Packet processing pipeline */
 /* 1. Sync packet processing */
 void Node::SendSyncInterest() {
-  std::string encoded_vv = EncodeVVToNameWithInterest(version_vector_, is_important_data_, surrounding_producers);
+  /**
+   * In delta mode, only carry the entries that changed since the last sync
+   *  interest actually sent. Send the full vector periodically, when a new
+   *  neighbor shows up, and while hibernating (whoever hears us next is new).
+   */
+  std::string encoded_vv;
+  if (!kDeltaSync || force_full_vv_ || is_hibernate ||
+      rounds_since_full_vv_ + 1 >= kFullVectorPeriod) {
+    encoded_vv = EncodedVV();
+    rounds_since_full_vv_ = 0;
+    force_full_vv_ = false;
+  } else {
+    VersionVector delta;
+    for (auto entry : version_vector_) {
+      if (entry.first == nid_ || !last_sent_vv_.Has(entry.first) ||
+          last_sent_vv_.Get(entry.first) < entry.second)
+        delta.Set(entry.first, entry.second);
+    }
+    EncodeVVWithInterest(delta, is_important_data_, encoded_vv, kVVFlagDelta);
+    rounds_since_full_vv_++;
+  }
+  pending_sync_vv_ = version_vector_;
   auto cur_time = ns3::Simulator::Now().GetMicroSeconds();
   auto pending_sync_notify = MakeSyncNotifyName(nid_, encoded_vv, cur_time);
   auto interest = std::make_shared<Interest>(pending_sync_notify, kSendOutInterestLifetime);
   interest->setMustBeFresh(true);
   Packet packet;
   packet.packet_type = Packet::INTEREST_TYPE;
+  packet.packet_origin = Packet::ORIGINAL;
   packet.interest = interest;
-  pending_sync_interest.clear();
-  // pending_sync_interest.push_back(packet);
-  GetQueueByType("SYNC_INTEREST").push_back(packet);
+  Enqueue(SendQueue::kSyncInterest, packet);  /* Replaces the queued one */
 }
 
 void Node::OnSyncInterest(const Interest &interest) {
 
   const auto& n = interest.getName();
-  // auto other_vv = DecodeVVFromName(ExtractEncodedVV(n));
-  auto ret = DecodeVVFromNameWithInterest(ExtractEncodedVV(n));
-  auto other_vv = ret.first;
-  auto other_interested = ret.second;
+  uint8_t vv_flags = kVVFlagNone;
+  VersionVector other_vv;
+  std::vector<NodeID> other_interested;
+  if (!DecodeVVWithInterest(ExtractEncodedVV(n), other_vv, other_interested, &vv_flags)) {
+    VSYNC_LOG_WARN("Invalid sync interest vector format: nid=" << nid_);
+    return;
+  }
+  bool is_delta = vv_flags & kVVFlagDelta;
+
+  /* Update soft state of one-hop neighbors, new neighbors get a full vector */
+  NodeID sender_id = ExtractNodeID(n);
+  auto neighbor = one_hop.find(sender_id);
+  if (neighbor != one_hop.end()) {
+    scheduler_.cancelEvent(neighbor -> second);
+  } else {
+    force_full_vv_ = true;
+    VSYNC_LOG_TRACE ("node(" << nid_ << ") add new one-hop neighbor: " << sender_id );
+  }
+  one_hop[sender_id] = scheduler_.scheduleEvent(kNeighborTimeout, [this, sender_id] {
+    one_hop.erase(sender_id);
+  });
 
   /* Update soft state of interested producers of nearby nodes */
   for (NodeID interested_node_id : other_interested) {
@@ -450,61 +978,15 @@ void Node::OnSyncInterest(const Interest &interest) {
   refreshHibernateTimer();
 
   /* Merge state vector, add missing data to pending_data_interest */
-  bool other_vector_new = false;
-  std::vector<Packet> missing_data;
-  VersionVector mv;     /* For encoding bundled interest */
-  for (auto entry : other_vv) {
-    auto node_id = entry.first;
-    auto seq_other = entry.second;
-    if (version_vector_.find(node_id) == version_vector_.end() ||
-        version_vector_[node_id] < seq_other) {
-      auto start_seq = version_vector_.find(node_id) == version_vector_.end() ?
-                       1: version_vector_[node_id] + 1;
-      for (auto seq = start_seq; seq <= seq_other; ++seq)
-        logger.logStateStore(node_id, seq);
-      version_vector_[node_id] = seq_other;
-    }
-
-    // Don't add uninterested data interest to queue
-    if (other_interested.find(node_id) == other_interested.end()) {
-      // VSYNC_LOG_TRACE ("node(" << nid_ << ") jump over uninterested producer: " << node_id );
-      // continue;
-    }
-
-    if (version_vector_data_.find(node_id) == version_vector_data_.end() ||
-        version_vector_data_[node_id] < seq_other) {
-      other_vector_new = true;
-      auto start_seq = version_vector_data_.find(node_id) == version_vector_data_.end() ?
-                       1: version_vector_data_[node_id] + 1;
-      mv[node_id] = start_seq;
-      for (auto seq = start_seq; seq <= seq_other; ++seq) {
-        // logger.logStateStore(node_id, seq);
-        if (is_important_data_(node_id) == false)  // Partial sync, skip data not interested
-          continue;
-        auto n = MakeDataName(node_id, seq);
-        Packet packet;
-        packet.packet_type = Packet::INTEREST_TYPE;
-        packet.packet_origin = Packet::ORIGINAL;
-        packet.last_sent_time = 0;
-        packet.last_sent_dist = 0;
-        packet.nRetries = kDataInterestRetries;
-        packet.interest = std::make_shared<Interest>(n, kSendOutInterestLifetime);
-        // const_cast<Interest*>(packet.interest.get())->setMustBeFresh(true);
-        missing_data.push_back(packet);
-      }
-      version_vector_data_[node_id] = seq_other;
-    }
-  }
-  for (size_t i = 0; i < missing_data.size(); ++i) {
-    // pending_data_interest.push_back(missing_data[i]);
-    GetQueueByType("DATA_INTEREST").push_back(missing_data[i]);
-  }
+  bool other_vector_new = MergeStateVector(other_vv);
 
   VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length: " <<
-                   pending_data_interest.size() + inf_retx_data_interest.size() + 
+                   missing_data_.size() + unbundled_data_.size() +
+                   send_queue_.Size(SendQueue::kDataInterest) +
+                   send_queue_.Size(SendQueue::kInfRetxDataInterest) +
                    num_scheduler_retx - pending_forward );
   VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length inf: " <<
-                   inf_retx_data_interest.size() + num_scheduler_retx_inf);
+                   send_queue_.Size(SendQueue::kInfRetxDataInterest) + num_scheduler_retx_inf);
 
   /* Do I have newer state? */
   /**
@@ -512,27 +994,19 @@ void Node::OnSyncInterest(const Interest &interest) {
    *  entire vector. Assume my vector is newer only when I have a larger
    *  sequence number than a producer that exists in the vector.
    */
-  bool my_vector_new = false;
-  for (auto entry: version_vector_) {
-    auto node_id = entry.first;
-    auto seq = entry.second;
-    // if (other_vv.find(node_id) == other_vv.end() ||
-    //     other_vv[node_id] < seq) {
-    if (other_vv.find(node_id) != other_vv.end() &&
-        other_vv[node_id] < seq) {
-      my_vector_new = true;
-      break;
-    }
-  }
+  bool my_vector_new = version_vector_.IsNewerThan(other_vv);
 
 
-  /* If incoming state not newer, reset timer to delay sending next sync interest */
-  if (!other_vector_new && !my_vector_new) {  /* Case 1: Other vector same  */
+  /**
+   * If incoming state not newer, reset timer to delay sending next sync interest.
+   * A delta vector doesn't tell whether the other vector is the same as mine.
+   */
+  if (!other_vector_new && !my_vector_new && !is_delta) {  /* Case 1: Other vector same  */
     scheduler_.cancelEvent(retx_event);
-    int delay = retx_dist(rengine_);
+    int delay = retx_dist(retx_rng_);
     VSYNC_LOG_TRACE ("node(" << nid_ << ") Recv a syncNotify Interest:" << n.toUri()
                      << ", will reset retx timer" );
-    pending_sync_interest.clear();
+    send_queue_.Clear(SendQueue::kSyncInterest);
     retx_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
       RetxSyncInterest();
     });
@@ -562,7 +1036,7 @@ void Node::OnSyncInterest(const Interest &interest) {
       overheard_sync_interest.erase(p);
     }
     if (my_vector_new) {
-      int delay = dt_dist(rengine_);
+      int delay = dt_dist(ack_rng_);
       overheard_sync_interest[n] = scheduler_.scheduleEvent(
         time::microseconds(delay), [this, n] {
           overheard_sync_interest.erase(n);
@@ -572,7 +1046,7 @@ void Node::OnSyncInterest(const Interest &interest) {
       );
     }
     else {
-      int delay = ack_dist(rengine_);
+      int delay = ack_dist(ack_rng_);
       VSYNC_LOG_TRACE ("node(" << nid_ << ") will reply ACK without new state: " << n.toUri() );
       overheard_sync_interest[n] = scheduler_.scheduleEvent(
         time::microseconds(delay), [this, n] {
@@ -585,10 +1059,10 @@ void Node::OnSyncInterest(const Interest &interest) {
   else {
     int delay;
     if (my_vector_new) {
-      delay = dt_dist(rengine_);
+      delay = dt_dist(ack_rng_);
       VSYNC_LOG_TRACE ("node(" << nid_ << ") will reply ACK immediately:" << n.toUri() );
     } else {
-      delay = ack_dist(rengine_);
+      delay = ack_dist(ack_rng_);
       VSYNC_LOG_TRACE ("node(" << nid_ << ") will reply ACK with delay:" << n.toUri() );
     }
     scheduler_.scheduleEvent(time::microseconds(delay), [this, n] {
@@ -600,20 +1074,16 @@ void Node::OnSyncInterest(const Interest &interest) {
 /* Append vector to name just before sending out ACK for freshness */
 void Node::SendSyncAck(const Name &n) {
   std::shared_ptr<Data> ack = std::make_shared<Data>(n);
-  proto::AckContent content_proto;
-  // EncodeVV(version_vector_, content_proto.mutable_vv());
-  EncodeVVWithInterest(version_vector_, content_proto.mutable_vv(), is_important_data_, surrounding_producers);
-  const std::string& content_proto_str = content_proto.SerializeAsString();
-  ack->setContent(reinterpret_cast<const uint8_t*>(content_proto_str.data()),
-                  content_proto_str.size());
+  const std::string& encoded_vv = EncodedVV();
+  ack->setContent(reinterpret_cast<const uint8_t*>(encoded_vv.data()),
+                  encoded_vv.size());
   ack->setFreshnessPeriod(time::milliseconds(1000));
   key_chain_.sign(*ack, signingWithSha256());
 
   Packet packet;
   packet.packet_type = Packet::DATA_TYPE;
   packet.data = ack;
-  // pending_ack.push_back(packet);
-  GetQueueByType("SYNC_REPLY").push_back(packet);
+  Enqueue(SendQueue::kSyncReply, packet);
 }
 
 void Node::OnSyncAck(const Data &ack) {
@@ -622,11 +1092,12 @@ void Node::OnSyncAck(const Data &ack) {
   const auto& n = ack.getName();
   if (kSyncAckSuppression){
     /* Remove pending ACK from both pending events and queue */
+    const auto& pending_ack = send_queue_.Queue(SendQueue::kSyncReply);
     for (auto it = pending_ack.begin(); it != pending_ack.end(); ++it) {
       if (it->data->getName() == n) {
         // it = pending_ack.erase(it);  // TODO: Cause bug for unknown reason
         // try { pending_ack.erase(it); } catch (...) {}
-        pending_ack.clear();
+        send_queue_.Clear(SendQueue::kSyncReply);
         break;
       }
     }
@@ -641,69 +1112,21 @@ void Node::OnSyncAck(const Data &ack) {
   VSYNC_LOG_TRACE ("node(" << nid_ << ") RECV sync ack: " << ack.getName().toUri());
 
   /* Extract difference and add to pending_data_interest */
-  const auto& content = ack.getContent();
-  proto::AckContent content_proto;
-  if (!content_proto.ParseFromArray(content.value(), content.value_size())) {
-    VSYNC_LOG_WARN("Invalid data AckContent format: nid=" << nid_);
-    assert(false);
-  }
-  // auto vector_other = DecodeVV(content_proto.vv());
-  auto ret = DecodeVVWithInterest(content_proto.vv());
-  auto vector_other = ret.first;
-  auto other_interested = ret.second;
-  // bool other_vector_new = false;    /* Set if remote vector has newer state */
-  std::vector<Packet> missing_data;
-  for (auto entry : vector_other) {
-    auto node_id = entry.first;
-    auto node_seq = entry.second;
-
-    if (version_vector_.find(node_id) == version_vector_.end() ||
-        version_vector_[node_id] < node_seq) {
-      auto start_seq = version_vector_.find(node_id) == version_vector_.end() ?
-                       1: version_vector_[node_id] + 1;
-      for (auto seq = start_seq; seq <= node_seq; ++seq)
-        logger.logStateStore(node_id, seq);
-      version_vector_[node_id] = node_seq;
-    }
-
-    // Don't add uninterested data interest to queue
-    if (other_interested.find(node_id) == other_interested.end()) {
-      // VSYNC_LOG_TRACE ("node(" << nid_ << ") jump over uninterested producer: " << node_id );
-      // continue;
-    }
-
-    if (version_vector_data_.find(node_id) == version_vector_data_.end() ||
-        version_vector_data_[node_id] < node_seq) {
-      // other_vector_new = true;
-      auto start_seq = version_vector_data_.find(node_id) == version_vector_data_.end() ?
-                       1: version_vector_data_[node_id] + 1;
-      for (auto seq = start_seq; seq <= node_seq; ++seq) {
-        // logger.logStateStore(node_id, seq);
-        if (is_important_data_(node_id) == false)  // Partial sync, skip data not interested
-          continue;
-        auto n = MakeDataName(node_id, seq);
-        Packet packet;
-        packet.packet_type = Packet::INTEREST_TYPE;
-        packet.packet_origin = Packet::ORIGINAL;
-        packet.nRetries = kDataInterestRetries;
-        packet.last_sent_time = 0;
-        packet.last_sent_dist = 0;
-        packet.interest = std::make_shared<Interest>(n, kSendOutInterestLifetime);
-        missing_data.push_back(packet);
-      }
-      version_vector_data_[node_id] = node_seq;
-    }
-  }
-  for (size_t i = 0; i < missing_data.size(); ++i) {
-    // pending_data_interest.push_back(missing_data[i]);
-    GetQueueByType("DATA_INTEREST").push_back(missing_data[i]);
+  VersionVector vector_other;
+  std::vector<NodeID> interested;
+  if (!DecodeVVWithInterest(ack.getContent(), vector_other, interested)) {
+    VSYNC_LOG_WARN("Invalid sync ACK content format: nid=" << nid_);
+    return;
   }
+  MergeStateVector(vector_other);
 
   VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length: " <<
-                   pending_data_interest.size() + inf_retx_data_interest.size() +
+                   missing_data_.size() + unbundled_data_.size() +
+                   send_queue_.Size(SendQueue::kDataInterest) +
+                   send_queue_.Size(SendQueue::kInfRetxDataInterest) +
                    num_scheduler_retx - pending_forward );
   VSYNC_LOG_TRACE ("node(" << nid_ << ") Queue length inf: " <<
-                   inf_retx_data_interest.size() + num_scheduler_retx_inf);
+                   send_queue_.Size(SendQueue::kInfRetxDataInterest) + num_scheduler_retx_inf);
 }
 
 
@@ -717,27 +1140,20 @@ void Node::OnDataInterest(const Interest &interest) {
   refreshHibernateTimer();
   VSYNC_LOG_TRACE( "node(" << nid_ << ") Recv data interest: i.name=" << n.toUri());
 
-  auto iter = data_store_.find(n);
-  if (iter != data_store_.end()) {
+  auto stored = data_store_.Find(n);
+  if (stored) {
     Packet packet;
     packet.packet_type = Packet::DATA_TYPE;
-    if (is_static) { /* Set content type for repos */
-      Data data(n);
-      data.setFreshnessPeriod(time::seconds(3600));
-      data.setContent(iter->second->getContent().value(), iter->second->getContent().size());
-      data.setContentType(kRepoData);
-      key_chain_.sign(data, signingWithSha256());
-      packet.data = std::make_shared<Data>(data);
-      VSYNC_LOG_TRACE( "node(" << nid_ << ") Send type repo data = " << iter->second->getName());
+    packet.data = PrepareReply(stored);
+    if (is_static) {
+      VSYNC_LOG_TRACE( "node(" << nid_ << ") Send type repo data = " << stored->getName());
     } else {
-      packet.data = iter -> second;
-      VSYNC_LOG_TRACE( "node(" << nid_ << ") Will send type regular data = " << iter->second->getName());
+      VSYNC_LOG_TRACE( "node(" << nid_ << ") Will send type regular data = " << stored->getName());
     }
-    // pending_data_reply.push_back(packet);
-    GetQueueByType("DATA_REPLY").push_back(packet);
+    Enqueue(SendQueue::kDataReply, packet);
   } else if (kMultihopData) {
     /* Otherwise add to my PIT, but send probabilistically */
-    int p = mhop_dist(rengine_);
+    int p = mhop_dist(mhop_rng_);
     if (p < pMultihopForwardDataInterest) {
       Packet packet;
       packet.packet_type = Packet::INTEREST_TYPE;
@@ -748,7 +1164,8 @@ void Node::OnDataInterest(const Interest &interest) {
        * Need to remove PIT, otherwise interferes with checking PIT entry.
        * Remove only in-record of wifi face, and out-record of app face.
        **/
-      pending_data_interest.push_front(packet);
+      send_queue_.PushFront(SendQueue::kDataInterest, packet,
+                            ns3::Simulator::Now().GetMicroSeconds());
       pending_forward++;
       VSYNC_LOG_TRACE( "node(" << nid_ << ") Add forwarded interest to queue: i.name=" << n.toUri());
 
@@ -773,11 +1190,13 @@ void Node::OnDataReply(const Data &data, Packet::SourceType sourceType) {
 
   const auto& n = data.getName();
   NodeID node_id = ExtractNodeID(n);
-  // uint64_t seq = ExtractSequence(n);
-  if (data_store_.find(n) != data_store_.end()) {
+  uint64_t seq = ExtractSequence(n);
+  /* Data evicted under a memory budget is not stored and counted again */
+  if (data_store_.WasStored(node_id, seq)) {
     VSYNC_LOG_TRACE( "node(" << nid_ << ") Drops duplicate data: name=" << n.toUri());
     return;
   }
+  RemoveDataInterest(n);
 
   /* Print based on source */
   switch(sourceType) {
@@ -799,23 +1218,19 @@ void Node::OnDataReply(const Data &data, Packet::SourceType sourceType) {
    *  calculate data availability.
    */
   if (is_important_data_(node_id)) {
-    /* Check content type */
+    /* Check content type. The repo flag is cleared lazily, see PrepareReply() */
+    data_store_.Insert(n, data.shared_from_this());
     if (data.getContentType() == kRepoData) {
-      std::shared_ptr<Data> data_no_flag = std::make_shared<Data>(n);
-      data_no_flag -> setFreshnessPeriod(time::seconds(3600));
-      data_no_flag -> setContent(data.getContent().value(), data.getContent().size());
-      data_no_flag -> setContentType(kUserData);
-      key_chain_.sign(*data_no_flag, signingWithSha256());
-      data_store_[n] = data_no_flag;
       VSYNC_LOG_TRACE( "node(" << nid_ << ") Receive data from repo: name=" << n.toUri());
       if (!is_static)
         received_data_mobile_from_repo++;
-    } else {
-      data_store_[n] = data.shared_from_this();
     }
     if (!is_static)
        received_data_mobile++;
     logger.logDataStore(n);
+    if (on_data_store_)
+      on_data_store_(node_id, seq, seq);
+    RecordSyncLatency(data, sourceType);
   }
 
 
@@ -827,7 +1242,7 @@ void Node::OnDataReply(const Data &data, Packet::SourceType sourceType) {
     Packet packet;
     packet.packet_type = Packet::DATA_TYPE;
     // if (!is_static) {
-      packet.data = std::make_shared<Data>(data);
+      packet.data = data.shared_from_this();
     //   VSYNC_LOG_TRACE( "node(" << nid_ << ") Re-broadcasting data reply: " << n.toUri() );
     // } else {
     //   /* Mark data as from repo */
@@ -839,15 +1254,159 @@ void Node::OnDataReply(const Data &data, Packet::SourceType sourceType) {
     //   packet.data = std::make_shared<Data>(data_with_flag);
     //   VSYNC_LOG_TRACE( "node(" << nid_ << ") Re-broadcasting data reply: " << n.toUri() );
     // }
-    // pending_data_reply.push_back(packet);
-    GetQueueByType("DATA_REPLY").push_back(packet);
+    Enqueue(SendQueue::kDataReply, packet);
+  }
+}
+
+/**
+ * Return stored data in the form this node serves it: repos mark data as
+ *  kRepoData, mobile nodes serve it unmarked. Data is stored as received, and
+ *  replaced by the re-signed copy the first time it is served in the other
+ *  form, so every item is signed at most once per node.
+ */
+std::shared_ptr<const Data> Node::PrepareReply(const std::shared_ptr<const Data>& stored) {
+  uint32_t type = is_static ? kRepoData : kUserData;
+  if ((stored->getContentType() == kRepoData) == is_static)
+    return stored;
+
+  std::shared_ptr<Data> data = std::make_shared<Data>(stored->getName());
+  data->setFreshnessPeriod(time::seconds(3600));
+  data->setContent(stored->getContent().value(), stored->getContent().size());
+  data->setContentType(type);
+  key_chain_.sign(*data, signingWithSha256());
+  data_store_.Insert(data->getName(), data);
+  return data;
+}
+
+/**
+ * Reply with as many of the requested data as fit in one packet, in seq
+ *  order. Carry my vector in nextvv so the requester can continue from it.
+ *  Stay silent if I have none of them.
+ */
+void Node::OnBundledDataInterest(const Interest &interest) {
+  const auto& n = interest.getName();
+  refreshHibernateTimer();
+  VSYNC_LOG_TRACE( "node(" << nid_ << ") Recv bundled data interest: i.name=" << n.toUri());
+
+  NodeID node_id = ExtractBundleNodeID(n);
+  uint64_t first = ExtractBundleFirst(n);
+  uint64_t last = ExtractBundleLast(n);
+
+  proto::PackData pack;
+  pack.set_nextvv(EncodedVV());
+  size_t pack_size = pack.nextvv().size();
+  for (uint64_t seq = first; seq <= last; ++seq) {
+    auto stored = data_store_.Find(node_id, seq);
+    if (!stored)
+      continue;
+    stored = PrepareReply(stored);
+    const Block& wire = stored->wireEncode();
+    std::string name = stored->getName().toUri();
+    size_t entry_size = name.size() + wire.size() + 16;   /* Roughly, with protobuf framing */
+    if (pack_size + entry_size > kMaxDataContent)
+      break;
+    pack_size += entry_size;
+    auto entry = pack.add_entry();
+    entry->set_name(name);
+    entry->set_content(wire.wire(), wire.size());
+  }
+  if (pack.entry_size() == 0)
+    return;
+
+  std::shared_ptr<Data> data = std::make_shared<Data>(n);
+  data->setFreshnessPeriod(time::seconds(1));
+  const std::string& pack_str = pack.SerializeAsString();
+  data->setContent(reinterpret_cast<const uint8_t*>(pack_str.data()), pack_str.size());
+  key_chain_.sign(*data, signingWithSha256());
+
+  Packet packet;
+  packet.packet_type = Packet::DATA_TYPE;
+  packet.data = data;
+  Enqueue(SendQueue::kDataReply, packet);
+  VSYNC_LOG_TRACE( "node(" << nid_ << ") Will send bundled data = " << n.toUri()
+                   << ", entries = " << pack.entry_size() );
+}
+
+/**
+ * Store every packed data as if it arrived alone, then put seqs of the range
+ *  that did not fit back into the missing data tracker.
+ */
+void Node::OnBundledData(const Interest &interest, const Data &data) {
+  const auto& n = interest.getName();
+  NodeID node_id = ExtractBundleNodeID(n);
+  uint64_t first = ExtractBundleFirst(n);
+  uint64_t last = ExtractBundleLast(n);
+
+  proto::PackData pack;
+  if (!pack.ParseFromArray(data.getContent().value(), data.getContent().value_size())) {
+    VSYNC_LOG_WARN( "node(" << nid_ << ") Malformed bundled data: name=" << data.getName().toUri());
+    OnBundledDataTimeout(interest);
+    return;
+  }
+  VSYNC_LOG_TRACE( "node(" << nid_ << ") Recv bundled data: name=" << data.getName().toUri()
+                   << ", entries = " << pack.entry_size() );
+
+  for (int i = 0; i < pack.entry_size(); ++i) {
+    const std::string& wire = pack.entry(i).content();
+    std::shared_ptr<Data> item;
+    try {
+      item = std::make_shared<Data>(Block(reinterpret_cast<const uint8_t*>(wire.data()), wire.size()));
+    } catch (const tlv::Error&) {
+      continue;
+    }
+    OnDataReply(*item, Packet::ORIGINAL);
+  }
+
+  RequeueBundle(node_id, first, last);
+
+  VersionVector other_vv;
+  std::vector<NodeID> interested;
+  if (DecodeVVWithInterest(reinterpret_cast<const uint8_t*>(pack.nextvv().data()),
+                           pack.nextvv().size(), other_vv, interested))
+    MergeStateVector(other_vv);
+}
+
+/**
+ * Nobody had any of the range. Put it back, it will be asked for again when
+ *  the data interest queue has room.
+ */
+void Node::OnBundledDataTimeout(const Interest &interest) {
+  const auto& n = interest.getName();
+  VSYNC_LOG_TRACE( "node(" << nid_ << ") Bundled data interest timeout: i.name=" << n.toUri());
+  RequeueBundle(ExtractBundleNodeID(n), ExtractBundleFirst(n), ExtractBundleLast(n));
+}
+
+/**
+ * Put seqs of a bundle that did not arrive back as missing. Data evicted under
+ *  a memory budget is not fetched again, only data known to exist and never
+ *  stored. A seq whose bundles failed kBundleRetries times is asked for with
+ *  a single data interest instead, which has retries and falls back to inf
+ *  retx.
+ */
+void Node::RequeueBundle(NodeID node_id, uint64_t first, uint64_t last) {
+  last = std::min(last, version_vector_data_.Get(node_id));
+  if (first > last)
+    return;
+  auto& attempts = bundle_attempts_[node_id];
+  attempts += std::make_pair(ReceiveWindow::SeqNumInterval::closed(first, last), 1);
+  for (uint64_t seq = first; seq <= last; ++seq) {
+    if (data_store_.WasStored(node_id, seq)) {
+      attempts.erase(seq);
+    } else if (attempts.find(seq)->second >= kBundleRetries) {
+      attempts.erase(seq);
+      unbundled_data_.Insert(node_id, seq, seq);
+    } else {
+      missing_data_.Insert(node_id, seq, seq);
+    }
   }
+  if (attempts.empty())
+    bundle_attempts_.erase(node_id);
 }
 
 /* 4. Pro-active events (beacons and sync interest retx) */
 void Node::RetxSyncInterest() {
   SendSyncInterest();
-  int delay = retx_dist(rengine_);
+  int delay = retx_dist(retx_rng_);
   scheduler_.cancelEvent(retx_event);
   retx_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
     RetxSyncInterest();
@@ -868,7 +1427,8 @@ void Node::refreshHibernateTimer() {
     return;
   if (is_hibernate) {
     VSYNC_LOG_TRACE( "node(" << nid_ << ") Leaves hibernate mode" );
-    int delay = packet_dist(rengine_);
+    force_full_vv_ = true;
+    int delay = packet_dist(packet_rng_);
     scheduler_.cancelEvent(packet_event);
     packet_event = scheduler_.scheduleEvent(time::microseconds(delay), [this] {
       AsyncSendPacket();
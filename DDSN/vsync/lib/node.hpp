@@ -6,8 +6,11 @@
 #include <functional>
 #include <exception>
 #include <map>
-#include <deque>
+#include <list>
 #include <unordered_map>
+#include <unordered_set>
+
+#include <boost/icl/interval_map.hpp>
 
 #include "ndn-common.hpp"
 #include "vsync-common.hpp"
@@ -15,6 +18,11 @@
 #include "recv-window.hpp"
 #include "logging.hpp"
 #include "odometer.hpp"
+#include "send-queue.hpp"
+#include "missing-data.hpp"
+#include "data-store.hpp"
+#include "random-stream.hpp"
+#include "metrics/metrics.hpp"
 
 namespace ndn {
 namespace vsync {
@@ -35,6 +43,7 @@ public:
     kVectorClock    = 9670
   };
 
+  using OnStore = std::function<void(NodeID producer, uint64_t first_seq, uint64_t last_seq)>;
   using GetCurrentPos = std::function<std::pair<double, double>()>;
   using GetNumSurroundingNodes = std::function<int()>;
 
@@ -59,6 +68,35 @@ public:
 
   void PublishData(const std::string& content, uint32_t type = kUserData);
 
+  /* For sampling gauges owned by the application, e.g. forwarder counters */
+  metrics::MetricsRegistry& GetMetrics() {
+    return metrics_;
+  }
+
+  /* Observe every data and state this node stores, e.g. for a convergence oracle */
+  void SetOnStore(const OnStore& on_data_store, const OnStore& on_state_store) {
+    on_data_store_ = on_data_store;
+    on_state_store_ = on_state_store;
+  }
+
+  /* Print the statistics syncDuration.py parses. Normally done at 2395s */
+  void PrintStatistics();
+
+  /* Tell the data store which data every node already holds */
+  void SetIsReplicated(const DataStore::IsReplicated& is_replicated) {
+    data_store_.SetIsReplicated(is_replicated);
+  }
+
+  /* Checkpoint of the node state at the current simulated time */
+  void SaveSnapshot(proto::NodeSnapshot& snapshot) const;
+
+  /**
+   * Make this new node continue from a checkpoint at the checkpoint's time,
+   *  instead of starting at 2s. Return false if the snapshot is not of this
+   *  node or its time has passed.
+   */
+  bool LoadSnapshot(const proto::NodeSnapshot& snapshot);
+
 private:
   /* Node properties */
   Node(const Node&) = delete;
@@ -68,24 +106,34 @@ private:
   KeyChain& key_chain_;
   const NodeID nid_;            /* To be configured by application */
   Name prefix_;                 /* To be configured by application */
-  std::random_device rdevice_;
-  std::mt19937 rengine_;
+  /* One stream per purpose, see random-stream.hpp */
+  RandomStream data_generation_rng_;
+  RandomStream packet_rng_;
+  RandomStream retx_rng_;
+  RandomStream ack_rng_;
+  RandomStream mhop_rng_;
   Logger logger;
 
   /* Node states */
   VersionVector version_vector_;
   VersionVector version_vector_data_;   /* Data interest already added */
-  std::unordered_map<Name, std::shared_ptr<const Data>> data_store_;
+  VersionVector pending_sync_vv_;       /* Vector carried by the queued sync interest */
+  VersionVector last_sent_vv_;          /* Vector carried by the last sync interest sent */
+  unsigned int rounds_since_full_vv_;   /* No. of delta sync interests since last full vector */
+  bool force_full_vv_;                  /* Send full vector in next sync interest (e.g. new neighbor) */
+  std::string encoded_vv_;              /* Cached encoding of version_vector_ */
+  uint64_t encoded_vv_version_;         /* version_vector_.Version() encoded_vv_ was made from */
+  bool encoded_vv_valid_;
+  DataStore data_store_;
   bool generate_data;           /* If false, PubishData() returns immediately */
   unsigned int notify_time;     /* No. of retx left for same sync interest */
   unsigned int left_retx_count; /* No. of retx left for same data interest */
-  std::deque<Packet> pending_ack;           /* Multi-level queue */
-  std::deque<Packet> pending_sync_interest;
-  std::deque<Packet> pending_data_reply;
-  std::deque<Packet> pending_data_interest;
-  std::deque<Packet> inf_retx_data_interest;
+  SendQueue send_queue_;         /* Multi-level queue */
+  MissingDataTracker missing_data_;  /* Missing data not yet in the data interest queue */
+  MissingDataTracker unbundled_data_;  /* Missing data of failed bundles, asked for one by one */
+  std::map<NodeID, boost::icl::interval_map<uint64_t, int>> bundle_attempts_;  /* Failed bundles per seq */
   Name waiting_data;            /* Name of outstanding data interest from pending_interest queue */
-  std::unordered_map<NodeID, EventId> one_hop;              /* Nodes within one-hop distance */
+  std::unordered_map<NodeID, EventId> one_hop;              /* Soft state of nodes within one-hop distance */
   std::unordered_map<Name, EventId> overheard_sync_interest;/* For sync ack suppression */
   std::unordered_map<NodeID, EventId> surrounding_producers;/* Soft state of interested producers of nearby nodes */
   bool is_static;               /* Static nodes don't generate data or log store */
@@ -93,6 +141,9 @@ private:
   size_t num_scheduler_retx;    /* Number of data interest the scheduler will put back to the queue (for statistics) */
   size_t num_scheduler_retx_inf;/* Number of data interest the scheduler will put back to the inf retx queue (for statistics) */
   size_t pending_forward;       /* Number of data interest in queue that will be forwarded */
+  std::unordered_set<Name> retx_in_flight_;   /* Original data interests the scheduler will put back to a queue */
+  std::list<Name> inf_retx_age_;              /* Inf retx data interests (queued or in flight), oldest first */
+  std::unordered_map<Name, std::list<Name>::iterator> inf_retx_age_index_;
 
   /* Constants */
   const int kInterestTransmissionTime = 1;  /* Times same data interest sent */
@@ -117,8 +168,12 @@ private:
   // const int data_generation_rate_mean = 10000;
   std::poisson_distribution<> data_generation_dist
     = std::poisson_distribution<>(data_generation_rate_mean);
-  // Threshold for bundled data fetching
+  // Threshold for bundled data fetching: runs longer than this are bundled (e.g. 4)
   const size_t kMissingDataThreshold = 0x7fffffff;
+  // Max number of seqs asked for in one bundled interest
+  const size_t kMaxBundleLength = 64;
+  // Failed bundles before their seqs fall back to single data interests
+  const int kBundleRetries = 3;
   // MTU
   const size_t kMaxDataContent = 4000;
   // Delay for sending everything to avoid collision
@@ -138,13 +193,28 @@ private:
   std::uniform_int_distribution<> beacon_dist
     = std::uniform_int_distribution<>(2000000, 3000000);
   const int kDataInterestRetries = 10;
+  const int kDataInterestWindow = 50;     /* Max data interests materialized in queue */
   const int kInfRetxNum = 10000;   // Limit the number of inf retx data interests
+  // Every kFullVectorPeriod-th sync interest carries the full vector in delta mode
+  const unsigned int kFullVectorPeriod = 4;
+  // Timeout of one-hop neighbor soft state
+  const time::milliseconds kNeighborTimeout = time::milliseconds(3000);
 
   /* Options */
   /*const*/ bool kRetx =     true;        /* Use sync interest retx? */
   const bool kMultihopSync = true;        /* Use multihop for sync? */
   const bool kMultihopData = true;       /* Use multihop for data? */
   const bool kSyncAckSuppression = true;
+  const bool kDeltaSync = false;          /* Only carry changed entries in sync interest? */
+  const bool kBundledData = false;        /* Fetch runs of missing data with bundled interests? */
+  /* Data store memory budget in bytes (0 = unbounded) and eviction policy */
+  const size_t kDataStoreBudget = 0;
+  const DataStore::EvictionPolicy kDataStoreEviction = DataStore::kOldestFirst;
+  /* Send queue scheduling, strict priority as in the baseline. DRR keeps a steady stream of
+     ACKs from starving inf retx. Weights are in packets (WRR) or kMaxDataContent quanta (DRR)
+     per round */
+  const SendQueue::Scheduling kSendQueueScheduling = SendQueue::kStrictPriority;
+  const size_t kSendQueueWeights[SendQueue::kNumTypes] = {4, 4, 1, 4, 1};
 
   /* Callbacks */
   DataCb data_cb_;                      /* Never used in simulation */
@@ -152,25 +222,40 @@ private:
   GetCurrentPos getCurrentPos_;
   GetNumSurroundingNodes getNumSurroundingNodes_;
   Odometer odometer;
+  OnStore on_data_store_;
+  OnStore on_state_store_;
 
-  /* Node statistics */
+  /* Node statistics, sampled over time if metrics export is enabled */
+  metrics::MetricsRegistry metrics_;
   // Sent
-  unsigned int suppressed_sync_interest;  /* No of sync interest suppressed */
-  unsigned int data_reply;                /* No of data sent */
+  metrics::Counter& suppressed_sync_interest;  /* No of sync interest suppressed */
+  metrics::Counter& data_reply;                /* No of data sent */
   // Received
-  unsigned int should_receive_sync_interest;   /* No of interest should received receiver side (for collision rate) */
-  unsigned int received_sync_interest;    /* No of sync interest received */
-  unsigned int received_data_interest;    /* No of data interest received */
-  unsigned int received_data_mobile;      /* No of data received (if this node is mobile) */
-  unsigned int received_data_mobile_from_repo;  /* No of data mobile nodes received from repo */
+  metrics::Counter& should_receive_sync_interest;   /* No of interest should received receiver side (for collision rate) */
+  metrics::Counter& received_sync_interest;    /* No of sync interest received */
+  metrics::Counter& received_data_interest;    /* No of data interest received */
+  metrics::Counter& received_data_mobile;      /* No of data received (if this node is mobile) */
+  metrics::Counter& received_data_mobile_from_repo;  /* No of data mobile nodes received from repo */
   int64_t hibernate_start;                /* Hibernation start time if in hibernation mode (micro-sec) */
   int64_t hibernate_duration;             /* Cumulative duration in hibernate mode (micro-sec) */
 
   /* Helper functions */
   void StartSimulation();
+  void RestoreSnapshot(const proto::NodeSnapshot& snapshot);
   void PrintNDNTraffic();
   void RemoveOldestInfInterest();
-  std::deque<Packet>& GetQueueByType(const std::string &type);
+  void AddInfRetxInterest(Packet packet);
+  bool HasDataInterest(const Name& n) const;
+  void RemoveDataInterest(const Name& n);
+  void Enqueue(SendQueue::Type type, const Packet& packet);
+  void PrintQueueStats();
+  void AddMetricGauges();
+  void SampleMetrics();
+  void RecordSyncLatency(const Data& data, Packet::SourceType sourceType);
+  int64_t HibernateDuration() const;   /* Including the current hibernation (micro-sec) */
+  bool MergeStateVector(const VersionVector& other_vv);
+  const std::string& EncodedVV();
+  void FillDataInterestQueue();
 
   /* Packet processing pipeline */
   /* Unified queue for outgoing interest */
@@ -189,6 +274,11 @@ private:
   void OnDataInterest(const Interest &interest);
   void SendDataReply();
   void OnDataReply(const Data &data, Packet::SourceType sourceType);
+  std::shared_ptr<const Data> PrepareReply(const std::shared_ptr<const Data>& stored);
+  void OnBundledDataInterest(const Interest &interest);
+  void OnBundledData(const Interest &interest, const Data &data);
+  void OnBundledDataTimeout(const Interest &interest);
+  void RequeueBundle(NodeID node_id, uint64_t first, uint64_t last);
   EventId wt_data_interest; /* Event for sending next data interest */
 
   /* 3. Pro-active events (beacons and sync interest retx) */
@@ -198,6 +288,7 @@ private:
   EventId beacon_event;     /* will send retx next beacon */
   EventId packet_event;     /* Will send next packet async */
   EventId hibernate_event;  /* Will enter hibernate mode */
+  EventId start_event;      /* Will start simulation, or restore a checkpoint */
 };
 
 } // namespace vsync
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_RANDOM_STREAM_HPP_
+#define NDN_VSYNC_RANDOM_STREAM_HPP_
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace ndn {
+namespace vsync {
+
+/**
+ * @brief Seedable random number stream, usable with the std distributions.
+ *
+ * A node draws from one stream per purpose, each seeded from the simulation
+ * seed, the run number, the node id and the purpose. A run is therefore
+ * reproduced exactly by the same seed and run number, and a change in how
+ * often one timer draws does not shift the numbers of the others, so two
+ * configurations compared under the same seed see the same randomness
+ * wherever they behave alike.
+ */
+class RandomStream {
+ public:
+  using result_type = std::mt19937::result_type;
+
+  enum Purpose : uint64_t {
+    kDataGeneration = 0,  /* Data generation intervals */
+    kPacket         = 1,  /* Sending delays of the send queue */
+    kRetx           = 2,  /* Retx timers */
+    kAck            = 3,  /* Sync ack delays */
+    kMultiHop       = 4,  /* Multi-hop forwarding decisions */
+    kNumPurposes
+  };
+
+  /**
+   * @brief Seed of the stream for @p purpose of @p node.
+   */
+  static uint64_t
+  Seed(uint64_t seed, uint64_t run, uint64_t node, uint64_t purpose) {
+    uint64_t h = Mix(seed);
+    h = Mix(h ^ run);
+    h = Mix(h ^ node);
+    return Mix(h ^ purpose);
+  }
+
+  explicit RandomStream(uint64_t seed)
+    : seed_(seed)
+  {
+    Reset();
+  }
+
+  result_type operator()() {
+    ++draws_;
+    return engine_();
+  }
+
+  static constexpr result_type min() { return std::mt19937::min(); }
+  static constexpr result_type max() { return std::mt19937::max(); }
+
+  uint64_t GetSeed() const {
+    return seed_;
+  }
+
+  /* Numbers drawn since the stream was seeded */
+  uint64_t Draws() const {
+    return draws_;
+  }
+
+  /**
+   * @brief Restart the stream, which then replays the same numbers.
+   */
+  void Reset() {
+    std::seed_seq seq = {static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)};
+    engine_.seed(seq);
+    draws_ = 0;
+  }
+
+  /**
+   * @brief Current position, for Restore() to continue from.
+   */
+  std::string Save() const {
+    std::ostringstream out;
+    out << seed_ << ' ' << draws_ << ' ' << engine_;
+    return out.str();
+  }
+
+  /**
+   * @return false, leaving the stream unchanged, if @p state is malformed
+   */
+  bool Restore(const std::string& state) {
+    std::istringstream in(state);
+    uint64_t seed, draws;
+    std::mt19937 engine;
+    if (!(in >> seed >> draws >> engine))
+      return false;
+    seed_ = seed;
+    draws_ = draws;
+    engine_ = engine;
+    return true;
+  }
+
+ private:
+  /* SplitMix64 finalizer: nearby inputs give unrelated seeds */
+  static uint64_t Mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  uint64_t seed_;
+  uint64_t draws_;
+  std::mt19937 engine_;
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_RANDOM_STREAM_HPP_
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "send-queue.hpp"
+
+namespace ndn {
+namespace vsync {
+
+SendQueue::SendQueue()
+  : quantum_(kDefaultQuantum)
+  , packet_size_(WireSize)
+  , scheduling_(kStrictPriority)
+  , current_(0)
+{
+  for (size_t i = 0; i < kNumTypes; ++i) {
+    stats_[i] = Stats{0, 0, 0, 0, 0};
+    weight_[i] = 1;
+    limit_[i] = 0;
+    drop_policy_[i] = kDropTail;
+    deficit_[i] = 0;
+  }
+}
+
+const char* SendQueue::TypeName(Type type) {
+  switch (type) {
+    case kSyncReply:            return "sync_reply";
+    case kDataReply:            return "data_reply";
+    case kSyncInterest:         return "sync_interest";
+    case kDataInterest:         return "data_interest";
+    case kInfRetxDataInterest:  return "inf_retx_data_interest";
+    default:                    return "unknown";
+  }
+}
+
+void SendQueue::SetScheduling(Scheduling scheduling) {
+  scheduling_ = scheduling;
+  current_ = 0;
+  deficit_.fill(0);
+}
+
+void SendQueue::SetWeight(Type type, size_t weight) {
+  weight_[type] = weight > 0 ? weight : 1;
+}
+
+void SendQueue::SetQuantum(size_t bytes) {
+  quantum_ = bytes > 0 ? bytes : 1;
+}
+
+void SendQueue::SetPacketSize(const PacketSize& packet_size) {
+  packet_size_ = packet_size;
+}
+
+void SendQueue::SetLimit(Type type, size_t limit, DropPolicy policy) {
+  limit_[type] = limit;
+  drop_policy_[type] = policy;
+}
+
+bool SendQueue::Push(Type type, Packet packet, int64_t now) {
+  if (!MakeRoom(type))
+    return false;
+  packet.enqueue_time = now;
+  queues_[type].push_back(std::move(packet));
+  stats_[type].enqueued++;
+  if (queues_[type].size() > stats_[type].max_depth)
+    stats_[type].max_depth = queues_[type].size();
+  return true;
+}
+
+bool SendQueue::PushFront(Type type, Packet packet, int64_t now) {
+  if (!MakeRoom(type))
+    return false;
+  packet.enqueue_time = now;
+  queues_[type].push_front(std::move(packet));
+  stats_[type].enqueued++;
+  if (queues_[type].size() > stats_[type].max_depth)
+    stats_[type].max_depth = queues_[type].size();
+  return true;
+}
+
+bool SendQueue::Pop(int64_t now, Packet& packet, Type& type) {
+  if (Empty())
+    return false;
+
+  if (scheduling_ == kStrictPriority) {
+    for (size_t i = 0; i < kNumTypes; ++i) {
+      if (!queues_[i].empty()) {
+        type = static_cast<Type>(i);
+        TakeFront(type, now, packet);
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Round robin: keep serving current level while it has credit left, then
+   *  move on and grant the next non-empty level a new quantum. Empty levels
+   *  lose their credit, as in DRR.
+   */
+  while (true) {
+    const PacketQueue& q = queues_[current_];
+    if (q.empty()) {
+      deficit_[current_] = 0;
+    } else {
+      size_t cost = scheduling_ == kDeficitRoundRobin ? packet_size_(q.front()) : 1;
+      if (cost <= deficit_[current_]) {
+        deficit_[current_] -= cost;
+        type = static_cast<Type>(current_);
+        TakeFront(type, now, packet);
+        return true;
+      }
+    }
+    current_ = (current_ + 1) % kNumTypes;
+    if (!queues_[current_].empty())
+      deficit_[current_] += scheduling_ == kDeficitRoundRobin ? weight_[current_] * quantum_
+                                                              : weight_[current_];
+  }
+}
+
+void SendQueue::Clear(Type type) {
+  queues_[type].clear();
+}
+
+bool SendQueue::Erase(Type type, const Name& name) {
+  return queues_[type].Erase(name);
+}
+
+bool SendQueue::Empty() const {
+  for (const auto& q : queues_) {
+    if (!q.empty())
+      return false;
+  }
+  return true;
+}
+
+bool SendQueue::MakeRoom(Type type) {
+  if (limit_[type] == 0 || queues_[type].size() < limit_[type])
+    return true;
+  stats_[type].dropped++;
+  if (drop_policy_[type] == kDropTail)
+    return false;
+  queues_[type].pop_front();
+  return true;
+}
+
+void SendQueue::TakeFront(Type type, int64_t now, Packet& packet) {
+  packet = queues_[type].pop_front();
+  stats_[type].dequeued++;
+  stats_[type].total_wait += now - packet.enqueue_time;
+}
+
+size_t SendQueue::WireSize(const Packet& packet) {
+  if (packet.packet_type == Packet::DATA_TYPE)
+    return packet.data->wireEncode().size();
+  return packet.interest->wireEncode().size();
+}
+
+}  // namespace vsync
+}  // namespace ndn
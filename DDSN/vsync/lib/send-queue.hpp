@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_SEND_QUEUE_HPP_
+#define NDN_VSYNC_SEND_QUEUE_HPP_
+
+#include <array>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
+#include "vsync-common.hpp"
+
+namespace ndn {
+namespace vsync {
+
+/**
+ * @brief FIFO of packets with an index on original interests by name.
+ *
+ * Backed by a linked list so that an interest can be found and removed by
+ * name in O(1), e.g. when its data arrives before it reaches the head.
+ * Forwarded interests and data are not indexed.
+ */
+class PacketQueue {
+ public:
+  using const_iterator = std::list<Packet>::const_iterator;
+
+  const_iterator begin() const { return packets_.begin(); }
+  const_iterator end() const { return packets_.end(); }
+  size_t size() const { return packets_.size(); }
+  bool empty() const { return packets_.empty(); }
+  const Packet& front() const { return packets_.front(); }
+  const Packet& back() const { return packets_.back(); }
+
+  void push_back(Packet packet) {
+    packets_.push_back(std::move(packet));
+    Index(std::prev(packets_.end()));
+  }
+
+  void push_front(Packet packet) {
+    packets_.push_front(std::move(packet));
+    Index(packets_.begin());
+  }
+
+  Packet pop_front() {
+    Unindex(packets_.begin());
+    Packet packet = std::move(packets_.front());
+    packets_.pop_front();
+    return packet;
+  }
+
+  void clear() {
+    packets_.clear();
+    index_.clear();
+  }
+
+  bool Contains(const Name& name) const {
+    return index_.count(name) > 0;
+  }
+
+  /**
+   * @brief Remove the original interest for @p name, if queued.
+   */
+  bool Erase(const Name& name) {
+    auto it = index_.find(name);
+    if (it == index_.end())
+      return false;
+    packets_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+ private:
+  static bool IsIndexed(const Packet& packet) {
+    return packet.packet_type == Packet::INTEREST_TYPE &&
+           packet.packet_origin == Packet::ORIGINAL;
+  }
+
+  void Index(std::list<Packet>::iterator it) {
+    if (IsIndexed(*it))
+      index_[it->interest->getName()] = it;
+  }
+
+  void Unindex(std::list<Packet>::iterator it) {
+    if (!IsIndexed(*it))
+      return;
+    auto entry = index_.find(it->interest->getName());
+    if (entry != index_.end() && entry->second == it)
+      index_.erase(entry);
+  }
+
+  std::list<Packet> packets_;
+  std::unordered_map<Name, std::list<Packet>::iterator> index_;
+};
+
+/**
+ * @brief Multi-level queue for outgoing packets.
+ *
+ * One FIFO per packet type, indexed by SendQueue::Type. Pop() picks the next
+ * packet according to the scheduling discipline:
+ *  - kStrictPriority: always serve the lowest non-empty Type first
+ *  - kWeightedRoundRobin: serve up to weight packets of a Type per round
+ *  - kDeficitRoundRobin: serve up to weight quanta of bytes of a Type per
+ *    round; a quantum should be at least the largest packet
+ *
+ * Each level can be bounded in depth, with either the new packet (drop tail)
+ * or the oldest packet (drop head) dropped when it is full.
+ */
+class SendQueue {
+ public:
+  enum Type : size_t {
+    kSyncReply = 0,
+    kDataReply,
+    kSyncInterest,
+    kDataInterest,
+    kInfRetxDataInterest,
+    kNumTypes
+  };
+
+  enum Scheduling {
+    kStrictPriority,
+    kWeightedRoundRobin,
+    kDeficitRoundRobin
+  };
+
+  using PacketSize = std::function<size_t(const Packet&)>;
+
+  enum DropPolicy {
+    kDropTail,
+    kDropHead
+  };
+
+  struct Stats {
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t dropped;
+    size_t max_depth;
+    int64_t total_wait;   /* Cumulative time dequeued packets spent in queue (micro-sec) */
+  };
+
+  SendQueue();
+
+  static const char* TypeName(Type type);
+
+  /**
+   * @brief Set scheduling discipline. Weights are packets per round for
+   * kWeightedRoundRobin, and quanta per round for kDeficitRoundRobin.
+   */
+  void SetScheduling(Scheduling scheduling);
+
+  void SetWeight(Type type, size_t weight);
+
+  /**
+   * @brief Set the bytes a weight of 1 earns per round of kDeficitRoundRobin.
+   */
+  void SetQuantum(size_t bytes);
+
+  /**
+   * @brief Set how kDeficitRoundRobin sizes a packet, its wire encoding by
+   *        default.
+   */
+  void SetPacketSize(const PacketSize& packet_size);
+
+  /**
+   * @brief Bound the depth of a level. A limit of 0 means unbounded.
+   */
+  void SetLimit(Type type, size_t limit, DropPolicy policy);
+
+  /**
+   * @brief Append a packet to its level, stamping its enqueue time.
+   * @return false if the packet was dropped
+   */
+  bool Push(Type type, Packet packet, int64_t now);
+
+  /**
+   * @brief Insert a packet at the head of its level (e.g. forwarded interest).
+   */
+  bool PushFront(Type type, Packet packet, int64_t now);
+
+  /**
+   * @brief Dequeue next packet to send.
+   * @return false if all levels are empty
+   */
+  bool Pop(int64_t now, Packet& packet, Type& type);
+
+  void Clear(Type type);
+
+  size_t Size(Type type) const {
+    return queues_[type].size();
+  }
+
+  bool Empty() const;
+
+  const PacketQueue& Queue(Type type) const {
+    return queues_[type];
+  }
+
+  bool Contains(Type type, const Name& name) const {
+    return queues_[type].Contains(name);
+  }
+
+  /**
+   * @brief Remove the original interest for @p name from a level in O(1).
+   */
+  bool Erase(Type type, const Name& name);
+
+  const Stats& GetStats(Type type) const {
+    return stats_[type];
+  }
+
+  /**
+   * @brief Append a packet saved from a checkpoint as is: neither its enqueue
+   *        time nor the stats are updated, and limits do not apply.
+   */
+  void Restore(Type type, Packet packet) {
+    queues_[type].push_back(std::move(packet));
+  }
+
+  void SetStats(Type type, const Stats& stats) {
+    stats_[type] = stats;
+  }
+
+ private:
+  static const size_t kDefaultQuantum = 1500;
+
+  bool MakeRoom(Type type);
+
+  void TakeFront(Type type, int64_t now, Packet& packet);
+
+  static size_t WireSize(const Packet& packet);
+
+  std::array<PacketQueue, kNumTypes> queues_;
+  std::array<Stats, kNumTypes> stats_;
+  std::array<size_t, kNumTypes> weight_;
+  size_t quantum_;                         /* Bytes per unit of weight (DRR) */
+  PacketSize packet_size_;
+  std::array<size_t, kNumTypes> limit_;
+  std::array<DropPolicy, kNumTypes> drop_policy_;
+  std::array<size_t, kNumTypes> deficit_;  /* Packets (WRR) or bytes (DRR) left this round */
+  Scheduling scheduling_;
+  size_t current_;                         /* Level being served by round robin */
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_SEND_QUEUE_HPP_
@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_VSYNC_VERSION_VECTOR_HPP_
+#define NDN_VSYNC_VERSION_VECTOR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ndn {
+namespace vsync {
+
+using NodeID = uint64_t;
+
+/**
+ * @brief Process-wide mapping from NodeID to a small dense index.
+ *
+ * Every VersionVector in the simulation shares the same index space, so that
+ * vectors can be looked up, compared and merged as plain arrays. NodeIDs below
+ * kDirectLimit (all NodeIDs in our scenarios) are mapped through a flat table;
+ * larger ones fall back to a hash map.
+ */
+class NodeIndex {
+ public:
+  static const size_t kNone = std::numeric_limits<size_t>::max();
+
+  /**
+   * @brief Return the index of @p nid, assigning a new one if it is unknown.
+   */
+  static size_t Get(NodeID nid) {
+    NodeIndex& self = Instance();
+    size_t idx = self.Lookup(nid);
+    if (idx != kNone)
+      return idx;
+    idx = self.ids_.size();
+    self.ids_.push_back(nid);
+    if (nid < kDirectLimit) {
+      if (self.direct_.size() <= nid)
+        self.direct_.resize(nid + 1, size_t(kNone));
+      self.direct_[nid] = idx;
+    } else {
+      self.indirect_[nid] = idx;
+    }
+    return idx;
+  }
+
+  /**
+   * @brief Return the index of @p nid, or kNone if it was never assigned one.
+   */
+  static size_t Find(NodeID nid) {
+    return Instance().Lookup(nid);
+  }
+
+  static NodeID At(size_t idx) {
+    return Instance().ids_[idx];
+  }
+
+ private:
+  static const NodeID kDirectLimit = 1 << 16;
+
+  static NodeIndex& Instance() {
+    static NodeIndex instance;
+    return instance;
+  }
+
+  size_t Lookup(NodeID nid) const {
+    if (nid < kDirectLimit)
+      return nid < direct_.size() ? direct_[nid] : size_t(kNone);
+    auto it = indirect_.find(nid);
+    return it == indirect_.end() ? size_t(kNone) : it->second;
+  }
+
+  std::vector<size_t> direct_;
+  std::unordered_map<NodeID, size_t> indirect_;
+  std::vector<NodeID> ids_;
+};
+
+/**
+ * @brief Dense version vector (vector clock).
+ *
+ * Sequence numbers are stored in a contiguous array indexed by NodeIndex. An
+ * entry can be absent, which is different from being present with seq 0:
+ * partial vectors received from the network only speak for the producers
+ * they carry.
+ *
+ * Iteration yields std::pair<NodeID, uint64_t> in index order.
+ *
+ * Version() changes whenever the vector may have changed, so derived data
+ * (e.g. the encoded vector) can be cached against it.
+ */
+class VersionVector {
+ public:
+  /* Marks an absent entry, so never a valid seq */
+  static const uint64_t kAbsent = std::numeric_limits<uint64_t>::max();
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<NodeID, uint64_t>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = value_type;
+
+    const_iterator(const std::vector<uint64_t>* seqs, size_t idx)
+      : seqs_(seqs), idx_(idx) { SkipAbsent(); }
+
+    value_type operator*() const {
+      return std::make_pair(NodeIndex::At(idx_), (*seqs_)[idx_]);
+    }
+    const_iterator& operator++() {
+      ++idx_;
+      SkipAbsent();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    bool operator==(const const_iterator& o) const { return idx_ == o.idx_; }
+    bool operator!=(const const_iterator& o) const { return idx_ != o.idx_; }
+
+   private:
+    void SkipAbsent() {
+      while (idx_ < seqs_->size() && (*seqs_)[idx_] == kAbsent)
+        ++idx_;
+    }
+
+    const std::vector<uint64_t>* seqs_;
+    size_t idx_;
+  };
+
+  VersionVector() : size_(0), version_(0) {}
+
+  VersionVector(std::initializer_list<std::pair<NodeID, uint64_t>> entries)
+    : size_(0), version_(0) {
+    for (const auto& entry : entries)
+      Set(entry.first, entry.second);
+  }
+
+  const_iterator begin() const { return const_iterator(&seqs_, 0); }
+  const_iterator end() const { return const_iterator(&seqs_, seqs_.size()); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  uint64_t Version() const { return version_; }
+
+  bool Has(NodeID nid) const {
+    size_t idx = NodeIndex::Find(nid);
+    return idx < seqs_.size() && seqs_[idx] != kAbsent;
+  }
+
+  /**
+   * @brief Return the seq of @p nid, or 0 if @p nid is absent.
+   */
+  uint64_t Get(NodeID nid) const {
+    size_t idx = NodeIndex::Find(nid);
+    return (idx < seqs_.size() && seqs_[idx] != kAbsent) ? seqs_[idx] : 0;
+  }
+
+  void Set(NodeID nid, uint64_t seq) {
+    (*this)[nid] = seq;
+  }
+
+  /**
+   * @brief Return a reference to the seq of @p nid, inserting 0 if absent.
+   * Counts as a modification.
+   */
+  uint64_t& operator[](NodeID nid) {
+    ++version_;
+    size_t idx = NodeIndex::Get(nid);
+    if (idx >= seqs_.size())
+      seqs_.resize(idx + 1, uint64_t(kAbsent));
+    if (seqs_[idx] == kAbsent) {
+      seqs_[idx] = 0;
+      ++size_;
+    }
+    return seqs_[idx];
+  }
+
+  void Erase(NodeID nid) {
+    size_t idx = NodeIndex::Find(nid);
+    if (idx < seqs_.size() && seqs_[idx] != kAbsent) {
+      seqs_[idx] = kAbsent;
+      --size_;
+      ++version_;
+    }
+  }
+
+  void Clear() {
+    seqs_.clear();
+    size_ = 0;
+    ++version_;
+  }
+
+  /**
+   * @brief Raise every entry to the one in @p other if @p other is newer.
+   *
+   * @p on_advance is called as on_advance(nid, old_seq, new_seq) for every
+   * entry that advances, before it is updated. An absent entry advances from 0.
+   *
+   * @return true if any entry advanced
+   */
+  template <typename F>
+  bool Merge(const VersionVector& other, F on_advance) {
+    bool advanced = false;
+    if (seqs_.size() < other.seqs_.size())
+      seqs_.resize(other.seqs_.size(), uint64_t(kAbsent));
+    for (size_t i = 0; i < other.seqs_.size(); ++i) {
+      uint64_t theirs = other.seqs_[i];
+      if (theirs == kAbsent)
+        continue;
+      uint64_t& mine = seqs_[i];
+      if (mine == kAbsent) {
+        on_advance(NodeIndex::At(i), 0, theirs);
+        mine = theirs;
+        ++size_;
+        advanced = true;
+      } else if (mine < theirs) {
+        on_advance(NodeIndex::At(i), mine, theirs);
+        mine = theirs;
+        advanced = true;
+      }
+    }
+    if (advanced)
+      ++version_;
+    return advanced;
+  }
+
+  bool Merge(const VersionVector& other) {
+    return Merge(other, [] (NodeID, uint64_t, uint64_t) {});
+  }
+
+  /**
+   * @brief Return true if some producer present in both vectors has a larger
+   * seq in this vector. Producers absent from @p other are not compared.
+   */
+  bool IsNewerThan(const VersionVector& other) const {
+    size_t n = std::min(seqs_.size(), other.seqs_.size());
+    for (size_t i = 0; i < n; ++i) {
+      if (seqs_[i] != kAbsent && other.seqs_[i] != kAbsent &&
+          other.seqs_[i] < seqs_[i])
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Sum of all sequence numbers (i.e. the number of known data items).
+   */
+  uint64_t Sum() const {
+    uint64_t sum = 0;
+    for (uint64_t seq : seqs_) {
+      if (seq != kAbsent)
+        sum += seq;
+    }
+    return sum;
+  }
+
+  bool operator==(const VersionVector& other) const {
+    if (size_ != other.size_)
+      return false;
+    size_t n = std::max(seqs_.size(), other.seqs_.size());
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t a = i < seqs_.size() ? seqs_[i] : uint64_t(kAbsent);
+      uint64_t b = i < other.seqs_.size() ? other.seqs_[i] : uint64_t(kAbsent);
+      if (a != b)
+        return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const VersionVector& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  std::vector<uint64_t> seqs_;  // Indexed by NodeIndex, kAbsent if no entry
+  size_t size_;                 // Number of present entries
+  uint64_t version_;            // Bumped on every modification
+};
+
+}  // namespace vsync
+}  // namespace ndn
+
+#endif  // NDN_VSYNC_VERSION_VECTOR_HPP_
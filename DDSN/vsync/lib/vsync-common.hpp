@@ -15,6 +15,7 @@
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/util/time.hpp>
 
+#include "version-vector.hpp"
 #include "vsync-message.pb.h"
 
 namespace ndn {
@@ -22,28 +23,31 @@ namespace vsync {
 
 // Type and constant declarations for VectorSync
 
-using NodeID = uint64_t;
-using VersionVector = std::unordered_map<NodeID, uint64_t>;
+// NodeID and VersionVector are declared in version-vector.hpp
 using heartbeatVector = std::unordered_map<NodeID, uint64_t>;
 using GroupID = std::string;
 
 static const Name kSyncNotifyPrefix = Name("/ndn/syncNotify");
 static const Name kSyncDataPrefix = Name("/ndn/vsyncData");
+static const Name kBundledDataPrefix = Name("/ndn/bundledData");
 static const Name kGetNDNTraffic = Name("/ndn/getNDNTraffic");
 
+// Fields default to zero, so that packets which never set them (e.g. ACKs)
+//  are checkpointed reproducibly
 typedef struct {
   std::shared_ptr<const Interest> interest;
   std::shared_ptr<const Data>     data;
 
-  enum PacketType { INTEREST_TYPE, DATA_TYPE }        packet_type;
-  enum SourceType { ORIGINAL, FORWARDED, SUPPRESSED } packet_origin;  // Used in data interest only
+  enum PacketType { INTEREST_TYPE, DATA_TYPE }        packet_type = INTEREST_TYPE;
+  enum SourceType { ORIGINAL, FORWARDED, SUPPRESSED } packet_origin = ORIGINAL;  // Used in data interest only
 
-  int64_t last_sent_time;   // Timestamp when this packet was sent last time
-  int64_t inf_retx_start_time;  // Timestamp when this packet entered inf retx queue
-  float last_sent_dist;     // Distance recorded when this packet was last sent 
-  int nRetries;
-  int retransmission_counter;
-  bool burst_packet;
+  int64_t last_sent_time = 0;   // Timestamp when this packet was sent last time
+  int64_t inf_retx_start_time = 0;  // Timestamp when this packet entered inf retx queue
+  int64_t enqueue_time = 0;     // Timestamp when this packet entered its send queue
+  float last_sent_dist = 0;     // Distance recorded when this packet was last sent 
+  int nRetries = 0;
+  int retransmission_counter = 0;
+  bool burst_packet = false;
 
 } Packet;
 
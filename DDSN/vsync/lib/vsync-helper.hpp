@@ -3,6 +3,7 @@
 #ifndef NDN_VSYNC_INTEREST_HELPER_HPP_
 #define NDN_VSYNC_INTEREST_HELPER_HPP_
 
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
@@ -17,160 +18,144 @@ namespace vsync {
 
 
 
-inline std::string EncodeVVToName(const VersionVector& v) {
-  std::string vv_encode = "";
-  for (auto entry: v) {
-    vv_encode += (to_string(entry.first) + "-" + to_string(entry.second) + "_");
+/**
+ * Binary encoding of a state vector, shared by the sync interest name and the
+ *  sync ACK / data content:
+ *
+ *    VV     := FLAGS COUNT BITMAP ENTRY{COUNT}
+ *    FLAGS  := 1 octet, encoding options (see kVVFlag*)
+ *    COUNT  := varint
+ *    BITMAP := ceil(COUNT / 8) octets, bit i set if the sender is interested
+ *              in data produced by the NodeID of entry i
+ *    ENTRY  := varint(NodeID) varint(seq)
+ *
+ * Varints are little-endian base-128 (7 bits per octet, MSB = continuation).
+ * The bitmap goes before the entries so that a decoder can produce both the
+ *  vector and the interested set in a single pass.
+ */
+static const uint8_t kVVFlagNone = 0x00;
+/* Vector only carries the entries changed since the sender's last sync interest */
+static const uint8_t kVVFlagDelta = 0x01;
+
+inline void AppendVarNumber(std::string& out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
   }
-  return vv_encode;
+  out.push_back(static_cast<char>(v));
 }
 
 /**
- * EncodeVVToNameWithInterest() - Encode version vector to name in format of :
- *  <NodeID>-<seq>-<interested>
- * Where interested is 0/1 indicating whether this node is interested in data
- *  produced by this NodeID.
+ * ReadVarNumber() - Read one varint from [*cur, end) and advance *cur.
+ * Return false if the buffer ends in the middle of the number, or the number
+ *  does not fit in 64 bits: longer than 10 octets, or with bits above bit 63
+ *  set in the 10th.
  */
-inline std::string
-EncodeVVToNameWithInterest(const VersionVector &v,
-                           std::function<bool(uint64_t)> is_important_data_,
-                           std::unordered_map<NodeID, EventId> surrounding_producers) {
-  std::string vv_encode = "";
-  for (auto entry : v) {
-    vv_encode += (to_string(entry.first) + "-" +
-                  to_string(entry.second) + "-");
-    // if (is_important_data_(entry.first) ||
-    //     surrounding_producers.find(entry.first) != surrounding_producers.end())
-    if (is_important_data_(entry.first))
-      vv_encode += "1_";
-    else
-      vv_encode += "0_";
+inline bool ReadVarNumber(const uint8_t** cur, const uint8_t* end, uint64_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*cur == end)
+      return false;
+    uint8_t b = *(*cur)++;
+    if (shift == 63 && b > 1)
+      return false;
+    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return true;
   }
-  return vv_encode;
+  return false;
 }
 
-
-inline VersionVector DecodeVVFromName(const std::string& vv_encode) {
-  int start = 0;
-  VersionVector vv;
-  for (size_t i = 0; i < vv_encode.size(); ++i) {
-    if (vv_encode[i] == '_') {
-      std::string str = vv_encode.substr(start, i - start);
-      size_t sep = str.find("-");
-      NodeID nid = std::stoull(str.substr(0, sep));
-      uint64_t seq = std::stoull(str.substr(sep + 1));
-      vv[nid] = seq;
-      start = i + 1;
-    }
+/**
+ * EncodeVVWithInterest() - Append the binary encoding of @p v to @p out.
+ *  @p is_important_data_ decides the interest bit of each entry.
+ */
+inline void
+EncodeVVWithInterest(const VersionVector& v,
+                     const std::function<bool(uint64_t)>& is_important_data_,
+                     std::string& out,
+                     uint8_t flags = kVVFlagNone) {
+  out.reserve(out.size() + 2 + (v.size() + 7) / 8 + v.size() * 6);
+  out.push_back(static_cast<char>(flags));
+  AppendVarNumber(out, v.size());
+  size_t bitmap_offset = out.size();
+  out.append((v.size() + 7) / 8, '\0');
+  size_t i = 0;
+  for (auto entry : v) {
+    if (is_important_data_(entry.first))
+      out[bitmap_offset + i / 8] |= static_cast<char>(1 << (i % 8));
+    AppendVarNumber(out, entry.first);
+    AppendVarNumber(out, entry.second);
+    ++i;
   }
-  return vv;
 }
 
 /**
- * DecodeVVFromNameWithInterest() - Given an encoded state vector encoded as:
- *  <NodeID>-<seq>-<interested>
- * Return the state vector, and a set of its interested nodes.
+ * DecodeVVWithInterest() - Decode a state vector encoded by
+ *  EncodeVVWithInterest() straight from the wire buffer into @p vv, and the
+ *  NodeIDs the sender is interested in into @p interested_nodes.
+ * Return false, with both cleared, if the buffer is malformed, including when
+ *  it carries VersionVector::kAbsent as a seq. An empty vector is valid.
  */
-inline std::pair<VersionVector, std::set<NodeID>>
-DecodeVVFromNameWithInterest(const std::string& vv_encode) {
-  int start = 0;
-  VersionVector vv;
-  std::set<NodeID> interested_nodes;
-  for (size_t i = 0; i < vv_encode.size(); ++i) {
-    if (vv_encode[i] == '_') {
-      std::string str = vv_encode.substr(start, i - start);
-      size_t cursor_1 = str.find("-");
-      size_t cursor_2 = str.find("-", cursor_1 + 1);
-      NodeID nid = std::stoll(str.substr(0, cursor_1));
-      uint64_t seq = std::stoll(str.substr(cursor_1 + 1, cursor_2));
-      bool is_important = std::stoll(str.substr(cursor_2 + 1));
-      if (is_important)
-        interested_nodes.insert(nid);
-      vv[nid] = seq;
-      start = i + 1;
+inline bool DecodeVVWithInterest(const uint8_t* buf, size_t buf_size, VersionVector& vv,
+                                 std::vector<NodeID>& interested_nodes,
+                                 uint8_t* flags = nullptr) {
+  vv = VersionVector();
+  interested_nodes.clear();
+  const uint8_t* cur = buf;
+  const uint8_t* end = buf + buf_size;
+  uint64_t count;
+  if (cur == end)
+    return false;
+  uint8_t f = *cur++;
+  /* Every entry takes at least two octets */
+  if (!ReadVarNumber(&cur, end, count) || count > buf_size / 2)
+    return false;
+  const uint8_t* bitmap = cur;
+  if (static_cast<size_t>(end - cur) < (count + 7) / 8)
+    return false;
+  cur += (count + 7) / 8;
+
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t nid, seq;
+    if (!ReadVarNumber(&cur, end, nid) || !ReadVarNumber(&cur, end, seq) ||
+        seq == VersionVector::kAbsent) {
+      vv = VersionVector();
+      interested_nodes.clear();
+      return false;
     }
+    vv.Set(nid, seq);
+    if (bitmap[i / 8] & (1 << (i % 8)))
+      interested_nodes.push_back(nid);
   }
-  return std::make_pair(vv, interested_nodes);
+  if (flags != nullptr)
+    *flags = f;
+  return true;
 }
 
-inline void EncodeVV(const VersionVector& v, proto::VV* vv_proto) {
-  for (auto item: v) {
-    auto* entry = vv_proto->add_entry();
-    entry->set_nid(item.first);
-    entry->set_seq(item.second);
-  }
+inline bool DecodeVVWithInterest(const name::Component& c, VersionVector& vv,
+                                 std::vector<NodeID>& interested_nodes,
+                                 uint8_t* flags = nullptr) {
+  return DecodeVVWithInterest(c.value(), c.value_size(), vv, interested_nodes, flags);
 }
 
-inline void EncodeVV(const VersionVector& v, std::string& out) {
-  proto::VV vv_proto;
-  EncodeVV(v, &vv_proto);
-  vv_proto.AppendToString(&out);
-}
-
-inline void 
-EncodeVVWithInterest(const VersionVector& v,
-                     proto::VV* vv_proto,
-                     std::function<bool(uint64_t)> is_important_data_,
-                     std::unordered_map<NodeID, EventId> surrounding_producers)
-{
-  for (auto item : v) {
-    auto* entry = vv_proto->add_entry();
-    entry->set_nid(item.first);
-    entry->set_seq(item.second);
-    // if (is_important_data_(item.first) ||
-    //     surrounding_producers.find(item.first) != surrounding_producers.end())
-    if (is_important_data_(item.first))
-      entry->set_interested(true);
-    else
-      entry->set_interested(false);
-  }
-}
-
-inline VersionVector DecodeVV(const proto::VV& vv_proto) {
-  VersionVector vv;
-  for (int i = 0; i < vv_proto.entry_size(); ++i) {
-    const auto& entry = vv_proto.entry(i);
-    auto nid = entry.nid();
-    auto seq = entry.seq();
-    vv[nid] = seq;
-  }
-  return vv;
-}
-
-inline VersionVector DecodeVV(const void* buf, size_t buf_size) {
-  proto::VV vv_proto;
-  if (!vv_proto.ParseFromArray(buf, buf_size)) {
-    VersionVector res;
-    return res;
-  }
-  return DecodeVV(vv_proto);
-}
-
-inline std::pair<VersionVector, std::set<NodeID>>
-DecodeVVWithInterest(const proto::VV& vv_proto)
-{
-  VersionVector vv;
-  std::set<NodeID> interested_nodes;
-  for (int i = 0; i < vv_proto.entry_size(); ++i) {
-    const auto& entry = vv_proto.entry(i);
-    auto nid = entry.nid();
-    auto seq = entry.seq();
-    auto interested = entry.interested();
-    vv[nid] = seq;
-    if (interested)
-      interested_nodes.insert(nid);
-  }
-  return std::make_pair(vv, interested_nodes);
+inline bool DecodeVVWithInterest(const Block& content, VersionVector& vv,
+                                 std::vector<NodeID>& interested_nodes,
+                                 uint8_t* flags = nullptr) {
+  return DecodeVVWithInterest(content.value(), content.value_size(), vv, interested_nodes,
+                              flags);
 }
 
 // Naming conventions for interests and data
 // TBD
 // actually, the [state-vector] is no needed to be carried because the carried data contains the vv.
 // but lixia said we maybe should remove the vv from data.
-inline Name MakeSyncNotifyName(const NodeID& nid, std::string encoded_vv, int64_t timestamp) {
-  // name = /[syncNotify_prefix]/[nid]/[state-vector]/[heartbeat-vector]
+inline Name MakeSyncNotifyName(const NodeID& nid, const std::string& encoded_vv, int64_t timestamp) {
+  // name = /[syncNotify_prefix]/[nid]/[state-vector]/[timestamp]
   Name n(kSyncNotifyPrefix);
-  n.appendNumber(nid).append(encoded_vv).appendNumber(timestamp);
+  n.appendNumber(nid)
+   .append(reinterpret_cast<const uint8_t*>(encoded_vv.data()), encoded_vv.size())
+   .appendNumber(timestamp);
   return n;
 }
 
@@ -181,12 +166,20 @@ inline Name MakeDataName(const NodeID& nid, uint64_t seq) {
   return n;
 }
 
+inline Name MakeBundledDataName(const NodeID& nid, uint64_t first, uint64_t last,
+                                int64_t timestamp) {
+  // name = /[bundledData_prefix]/[node_id]/[first seq]/[last seq]/[timestamp]
+  Name n(kBundledDataPrefix);
+  n.appendNumber(nid).appendNumber(first).appendNumber(last).appendNumber(timestamp);
+  return n;
+}
+
 inline uint64_t ExtractNodeID(const Name& n) {
   return n.get(-3).toNumber();
 }
 
-inline std::string ExtractEncodedVV(const Name& n) {
-  return n.get(-2).toUri();
+inline const name::Component& ExtractEncodedVV(const Name& n) {
+  return n.get(-2);
 }
 
 inline std::string ExtractEncodedMV(const Name& n) {
@@ -205,6 +198,18 @@ inline std::string ExtractTag(const Name& n) {
   return n.get(-1).toUri();
 }
 
+inline uint64_t ExtractBundleNodeID(const Name& n) {
+  return n.get(-4).toNumber();
+}
+
+inline uint64_t ExtractBundleFirst(const Name& n) {
+  return n.get(-3).toNumber();
+}
+
+inline uint64_t ExtractBundleLast(const Name& n) {
+  return n.get(-2).toNumber();
+}
+
 inline uint64_t ExtractBeaconSender(const Name& n) {
   return n.get(-3).toNumber();
 }
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include "convergence-oracle.hpp"
+
+using ndn::vsync::ConvergenceOracle;
+
+BOOST_AUTO_TEST_SUITE(TestConvergenceOracle);
+
+BOOST_AUTO_TEST_CASE(Target) {
+  BOOST_CHECK_EQUAL(ConvergenceOracle(20, 0.9).Target(), 18U);
+  BOOST_CHECK_EQUAL(ConvergenceOracle(5, 0.9).Target(), 4U);
+  BOOST_CHECK_EQUAL(ConvergenceOracle(1, 0.5).Target(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(Replication) {
+  ConvergenceOracle oracle(4, 0.5);   /* Items need 2 holders */
+  int converged = 0;
+  oracle.SetOnConverged([&converged] { converged++; });
+
+  /* Node 0 publishes seq 1 and 2 */
+  oracle.OnDataStore(10, 0, 0, 1, 1);
+  oracle.OnStateStore(10, 0, 0, 1, 1);
+  oracle.OnDataStore(20, 0, 0, 2, 2);
+  oracle.OnStateStore(20, 0, 0, 2, 2);
+  BOOST_CHECK_EQUAL(oracle.NumItems(), 2U);
+  BOOST_CHECK_EQUAL(oracle.NumPendingData(), 2U);
+
+  /* Duplicates do not count */
+  oracle.OnDataStore(25, 0, 0, 1, 1);
+  BOOST_CHECK(!oracle.IsDataReplicated(0, 1));
+
+  oracle.OnStateStore(30, 1, 0, 1, 2);
+  BOOST_CHECK_EQUAL(oracle.NumPendingState(), 0U);
+  oracle.OnDataStore(40, 1, 0, 1, 1);
+  BOOST_CHECK(oracle.IsDataReplicated(0, 1));
+  BOOST_CHECK(!oracle.IsDataReplicated(0, 2));
+  BOOST_CHECK(!oracle.IsDataReplicated(1, 1));
+  BOOST_CHECK_EQUAL(oracle.NumPendingData(), 1U);
+
+  /* Out-of-range nodes are ignored */
+  oracle.OnDataStore(45, 7, 0, 2, 2);
+  BOOST_CHECK_EQUAL(oracle.NumPendingData(), 1U);
+
+  /* Everything replicated, but data may still be generated */
+  oracle.OnDataStore(50, 2, 0, 2, 2);
+  BOOST_CHECK_EQUAL(oracle.NumPendingData(), 0U);
+  BOOST_CHECK(!oracle.IsConverged());
+  BOOST_CHECK_EQUAL(converged, 0);
+
+  oracle.StopGeneration();
+  BOOST_CHECK(oracle.IsConverged());
+  BOOST_CHECK_EQUAL(converged, 1);
+  BOOST_CHECK_EQUAL(oracle.LastReplicationTime(), 50);
+
+  oracle.OnDataStore(60, 3, 0, 1, 2);
+  BOOST_CHECK_EQUAL(converged, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GapsArePending) {
+  ConvergenceOracle oracle(2, 0.5);
+  oracle.StopGeneration();
+
+  /* Learning seq 3 implies seqs 1 and 2 exist */
+  oracle.OnStateStore(10, 1, 0, 3, 3);
+  BOOST_CHECK_EQUAL(oracle.NumPendingState(), 2U);
+  oracle.OnDataStore(10, 1, 0, 3, 3);
+  BOOST_CHECK_EQUAL(oracle.NumItems(), 3U);
+  BOOST_CHECK_EQUAL(oracle.NumPendingData(), 2U);
+  BOOST_CHECK(!oracle.IsConverged());
+
+  oracle.OnStateStore(20, 0, 0, 1, 3);
+  oracle.OnDataStore(20, 0, 0, 1, 2);
+  BOOST_CHECK(oracle.IsConverged());
+  BOOST_CHECK_EQUAL(oracle.LastReplicationTime(), 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
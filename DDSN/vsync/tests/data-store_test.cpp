@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include "data-store.hpp"
+
+using ndn::Data;
+using ndn::vsync::DataStore;
+using ndn::vsync::MakeDataName;
+using ndn::vsync::NodeID;
+
+namespace {
+
+std::shared_ptr<const Data> MakeData(NodeID nid, uint64_t seq) {
+  static ndn::KeyChain key_chain("pib-memory:", "tpm-memory:");
+  auto data = std::make_shared<Data>(MakeDataName(nid, seq));
+  key_chain.sign(*data, ndn::signingWithSha256());
+  return data;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestDataStore);
+
+BOOST_AUTO_TEST_CASE(InsertFind) {
+  DataStore store;
+  size_t size = MakeData(3, 1)->wireEncode().size();
+  store.Insert(MakeDataName(3, 1), MakeData(3, 1));
+  store.Insert(3, 2, MakeData(3, 2));
+  BOOST_CHECK_EQUAL(store.size(), 2U);
+  BOOST_CHECK_EQUAL(store.Bytes(), 2 * size);
+  store.Insert(70000, 5, MakeData(70000, 5));
+
+  BOOST_TEST(store.Contains(MakeDataName(3, 2)));
+  BOOST_TEST(!store.Contains(3, 3));
+  BOOST_TEST(!store.Contains(4, 1));
+  BOOST_TEST(store.Find(70000, 5) != nullptr);
+  BOOST_TEST(store.Find(MakeDataName(3, 9)) == nullptr);
+
+  /* Contains() does not count */
+  BOOST_CHECK_EQUAL(store.GetStats().hits, 1U);
+  BOOST_CHECK_EQUAL(store.GetStats().misses, 1U);
+
+  /* Replacing keeps one copy */
+  size_t bytes = store.Bytes();
+  store.Insert(3, 2, MakeData(3, 2));
+  BOOST_CHECK_EQUAL(store.size(), 3U);
+  BOOST_CHECK_EQUAL(store.Bytes(), bytes);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction) {
+  DataStore store;
+  store.Pin(1);
+  store.SetBudget(3 * MakeData(2, 1)->wireEncode().size());
+  store.Insert(1, 1, MakeData(1, 1));
+  store.Insert(2, 1, MakeData(2, 1));
+  store.Insert(2, 2, MakeData(2, 2));
+  store.Insert(2, 3, MakeData(2, 3));
+  BOOST_TEST(store.Contains(1, 1));   /* Pinned */
+  BOOST_TEST(!store.Contains(2, 1));  /* Oldest */
+  BOOST_CHECK_EQUAL(store.GetStats().evictions, 1U);
+
+  /* Evicted data was stored, data never inserted was not */
+  BOOST_TEST(store.WasStored(2, 1));
+  BOOST_TEST(store.WasStored(2, 2));
+  BOOST_TEST(!store.WasStored(2, 9));
+  BOOST_TEST(!store.WasStored(3, 1));
+  BOOST_CHECK_EQUAL(store.Slots(), 3U);   /* (2, 1) is dropped */
+
+  /* LRU: serving (2, 2) makes (2, 3) the next victim */
+  store.SetEvictionPolicy(DataStore::kLeastRecentlyUsed);
+  store.Find(2, 2);
+  store.Insert(2, 4, MakeData(2, 4));
+  BOOST_TEST(store.Contains(2, 2));
+  BOOST_TEST(!store.Contains(2, 3));
+
+  /* Replicated first */
+  store.SetEvictionPolicy(DataStore::kReplicatedFirst);
+  store.SetIsReplicated([] (NodeID, uint64_t seq) { return seq == 4; });
+  store.Insert(2, 5, MakeData(2, 5));
+  BOOST_TEST(store.Contains(2, 2));
+  BOOST_TEST(!store.Contains(2, 4));
+  BOOST_CHECK_EQUAL(store.size(), 3U);
+  BOOST_CHECK_EQUAL(store.GetStats().evictions, 3U);
+}
+
+BOOST_AUTO_TEST_CASE(Compaction) {
+  DataStore store;
+  store.SetBudget(2 * MakeData(2, 5)->wireEncode().size());
+  for (uint64_t seq = 5; seq <= 8; ++seq)
+    store.Insert(2, seq, MakeData(2, seq));
+
+  /* Only entries from the oldest stored data on are held */
+  BOOST_CHECK_EQUAL(store.Slots(), 2U);
+  BOOST_TEST(store.WasStored(2, 5));
+  BOOST_TEST(store.WasStored(2, 6));
+  BOOST_TEST(!store.WasStored(2, 4));
+  BOOST_TEST(!store.WasStored(2, 9));
+
+  /* Inserting below the table extends it, evicted seqs stay known */
+  store.Insert(2, 3, MakeData(2, 3));
+  BOOST_TEST(store.Contains(2, 3));
+  BOOST_TEST(!store.Contains(2, 7));
+  BOOST_TEST(!store.WasStored(2, 4));
+  BOOST_TEST(store.WasStored(2, 6));
+  BOOST_TEST(store.WasStored(2, 7));
+  BOOST_CHECK_EQUAL(store.Slots(), 6U);
+  BOOST_CHECK_EQUAL(store.size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachRecreatesOrder) {
+  DataStore store;
+  store.Pin(1);
+  store.SetEvictionPolicy(DataStore::kLeastRecentlyUsed);
+  store.Insert(2, 1, MakeData(2, 1));
+  store.Insert(1, 1, MakeData(1, 1));
+  store.Insert(2, 2, MakeData(2, 2));
+  store.Find(2, 1);
+
+  /* Pinned first, then least recently used first */
+  DataStore copy;
+  copy.Pin(1);
+  copy.SetEvictionPolicy(DataStore::kLeastRecentlyUsed);
+  std::vector<uint64_t> seqs;
+  store.ForEach([&] (NodeID nid, uint64_t seq, const std::shared_ptr<const Data>& data) {
+    seqs.push_back(nid * 10 + seq);
+    copy.Insert(nid, seq, data);
+  });
+  std::vector<uint64_t> expected = {11, 22, 21};
+  BOOST_CHECK(seqs == expected);
+  copy.SetStats(store.GetStats());
+  BOOST_CHECK_EQUAL(copy.GetStats().hits, 1U);
+  BOOST_CHECK_EQUAL(copy.GetStats().insertions, 3U);
+
+  /* Same victim */
+  copy.SetBudget(2 * MakeData(2, 1)->wireEncode().size());
+  BOOST_TEST(!copy.Contains(2, 2));
+  BOOST_TEST(copy.Contains(2, 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "event-log/event-log.hpp"
+
+using ndn::eventlog::EventLogReader;
+using ndn::eventlog::EventLogWriter;
+using ndn::eventlog::EventRecord;
+using ndn::eventlog::SpscRing;
+
+namespace eventlog = ndn::eventlog;
+
+BOOST_AUTO_TEST_SUITE(TestEventLog);
+
+BOOST_AUTO_TEST_CASE(WriteRead) {
+  const std::string path = "event-log-test.bin";
+  auto& writer = EventLogWriter::Instance();
+  writer.Open(path);
+  eventlog::LogEvent(10, 1, eventlog::kDataStore, 3, 7);
+  eventlog::LogEvent(20, 2, eventlog::kStateStore, "/chronosync/node-3/%07");
+  eventlog::LogEvent(30, 4, eventlog::kStateStore, "/chronosync/node-3/%07");
+  writer.Close();
+
+  EventLogReader reader;
+  BOOST_REQUIRE(reader.Open(path));
+  std::vector<EventRecord> records;
+  EventRecord record;
+  while (reader.Next(record))
+    records.push_back(record);
+
+  BOOST_REQUIRE_EQUAL(records.size(), 3U);
+  BOOST_CHECK_EQUAL(records[0].timestamp, 10);
+  BOOST_CHECK_EQUAL(records[0].node, 1U);
+  BOOST_CHECK_EQUAL(records[0].type, eventlog::kDataStore);
+  BOOST_CHECK_EQUAL(records[0].producer, 3U);
+  BOOST_CHECK_EQUAL(records[0].seq, 7U);
+  BOOST_CHECK_EQUAL(records[0].name_id, 0U);
+  BOOST_CHECK_EQUAL(reader.Name(records[0].name_id), "");
+
+  /* The name is interned once */
+  BOOST_CHECK_NE(records[1].name_id, 0U);
+  BOOST_CHECK_EQUAL(records[1].name_id, records[2].name_id);
+  BOOST_CHECK_EQUAL(reader.Name(records[1].name_id), "/chronosync/node-3/%07");
+
+  std::remove(path.c_str());
+  std::remove((path + ".names").c_str());
+}
+
+BOOST_AUTO_TEST_CASE(LateEvents) {
+  const std::string path = "event-log-test.bin";
+  auto& writer = EventLogWriter::Instance();
+  writer.Open(path);
+  eventlog::LogEvent(10, 1, eventlog::kDataStore, 3, 7);
+  writer.Close();
+
+  /* E.g. from a destructor after the run: dropped, the log is kept */
+  eventlog::LogEvent(20, 1, eventlog::kDataStore, 3, 8);
+  eventlog::LogEvent(30, 1, eventlog::kStateStore, "/chronosync/node-3/%08");
+  BOOST_CHECK_EQUAL(writer.GetStats().late, 2U);
+
+  EventLogReader reader;
+  BOOST_REQUIRE(reader.Open(path));
+  EventRecord record;
+  BOOST_REQUIRE(reader.Next(record));
+  BOOST_CHECK_EQUAL(record.seq, 7U);
+  BOOST_CHECK(!reader.Next(record));
+
+  std::remove(path.c_str());
+  std::remove((path + ".names").c_str());
+}
+
+BOOST_AUTO_TEST_CASE(WriterThread) {
+  const std::string path = "event-log-test.bin";
+  auto& writer = EventLogWriter::Instance();
+  writer.Open(path);
+  const uint64_t n = 200000;   /* Several times the ring capacity */
+  for (uint64_t i = 0; i < n; ++i)
+    eventlog::LogEvent(i, 1, eventlog::kStateStore, 2, i);
+  BOOST_CHECK_EQUAL(writer.GetStats().logged, n);
+  BOOST_CHECK_EQUAL(writer.GetStats().dropped, 0U);
+  writer.Flush();
+  writer.Close();
+
+  EventLogReader reader;
+  BOOST_REQUIRE(reader.Open(path));
+  EventRecord record;
+  uint64_t count = 0;
+  while (reader.Next(record) && record.seq == count)
+    ++count;
+  BOOST_CHECK_EQUAL(count, n);
+
+  std::remove(path.c_str());
+  std::remove((path + ".names").c_str());
+}
+
+BOOST_AUTO_TEST_CASE(Ring) {
+  SpscRing<int> ring(3);
+  BOOST_CHECK_EQUAL(ring.Capacity(), 4U);
+  std::vector<int> out;
+  auto write = [&out] (const int* items, size_t count) {
+    out.insert(out.end(), items, items + count);
+  };
+
+  for (int i = 0; i < 4; ++i)
+    BOOST_CHECK(ring.TryPush(i));
+  BOOST_CHECK(!ring.TryPush(4));
+  BOOST_CHECK_EQUAL(ring.Drain(write), 4U);
+  BOOST_CHECK(ring.Empty());
+
+  /* Wraps around */
+  for (int i = 4; i < 7; ++i)
+    ring.TryPush(i);
+  ring.Drain(write);
+  for (int i = 7; i < 10; ++i)
+    ring.TryPush(i);
+  BOOST_CHECK_EQUAL(ring.Drain(write), 3U);
+  BOOST_CHECK(out == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+BOOST_AUTO_TEST_CASE(NotALog) {
+  EventLogReader reader;
+  BOOST_CHECK(!reader.Open("no-such-event-log.bin"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "metrics/metrics.hpp"
+
+using ndn::metrics::Counter;
+using ndn::metrics::Histogram;
+using ndn::metrics::MetricsExporter;
+using ndn::metrics::MetricsRegistry;
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestMetrics);
+
+BOOST_AUTO_TEST_CASE(CounterOps) {
+  Counter c;
+  BOOST_CHECK_EQUAL(c.Value(), 0U);
+  c++;
+  ++c;
+  c += 3;
+  BOOST_CHECK_EQUAL(c.Value(), 5U);
+  uint64_t v = c;
+  BOOST_CHECK_EQUAL(v, 5U);
+  c.Set(42);
+  BOOST_CHECK_EQUAL(c.Value(), 42U);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramQuantiles) {
+  Histogram h(Histogram::ExponentialBounds(1, 2, 8));
+  BOOST_CHECK_EQUAL(h.Bounds().size(), 8U);
+  BOOST_CHECK_EQUAL(h.Bounds().back(), 128);
+  BOOST_CHECK(std::isnan(h.Quantile(0.5)));
+
+  for (int i = 1; i <= 100; ++i)
+    h.Record(i);
+  BOOST_CHECK_EQUAL(h.Count(), 100U);
+  BOOST_CHECK_EQUAL(h.Sum(), 5050);
+  BOOST_CHECK_EQUAL(h.Min(), 1);
+  BOOST_CHECK_EQUAL(h.Max(), 100);
+  BOOST_CHECK_EQUAL(h.Counts().size(), 9U);
+  BOOST_CHECK_EQUAL(h.Counts()[7], 36U);   /* (64, 128] */
+
+  /* Quantiles land in the right bucket and are monotonic */
+  double p50 = h.Quantile(0.5), p90 = h.Quantile(0.9), p99 = h.Quantile(0.99);
+  BOOST_CHECK(p50 > 32 && p50 <= 64);
+  BOOST_CHECK(p90 > 64 && p90 <= 100);
+  BOOST_CHECK(p50 <= p90 && p90 <= p99 && p99 <= 100);
+  BOOST_CHECK_EQUAL(h.Quantile(1), 100);
+
+  /* Values above the last bound go to the overflow bucket */
+  h.Record(1000);
+  BOOST_CHECK_EQUAL(h.Counts().back(), 1U);
+  BOOST_CHECK_EQUAL(h.Quantile(1), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramMerge) {
+  Histogram a({1, 10, 100});
+  Histogram b({1, 10, 100});
+  a.Record(5);
+  b.Record(50);
+  b.Record(500);
+  BOOST_CHECK(a.Merge(b));
+  BOOST_CHECK_EQUAL(a.Count(), 3U);
+  BOOST_CHECK_EQUAL(a.Sum(), 555);
+  BOOST_CHECK_EQUAL(a.Min(), 5);
+  BOOST_CHECK_EQUAL(a.Max(), 500);
+  BOOST_CHECK_EQUAL(a.Counts()[1], 1U);
+  BOOST_CHECK_EQUAL(a.Counts()[2], 1U);
+  BOOST_CHECK_EQUAL(a.Counts()[3], 1U);
+
+  Histogram other({1, 2});
+  other.Record(1);
+  BOOST_CHECK(!a.Merge(other));
+  BOOST_CHECK_EQUAL(a.Count(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(RegistryExport) {
+  std::string prefix = "/tmp/metrics-test-" + std::to_string(getpid());
+  MetricsExporter::Instance().Open(prefix, 100);
+  BOOST_CHECK(MetricsExporter::Instance().Enabled());
+  BOOST_CHECK_EQUAL(MetricsExporter::Instance().IntervalMs(), 100);
+
+  {
+    MetricsRegistry gone(7);
+    gone.GetCounter("sent") += 2;
+    gone.GetHistogram("delay", {1, 10, 100}).Record(50);
+    gone.Sample(0);
+  }
+
+  MetricsRegistry registry(3);
+  Counter& sent = registry.GetCounter("sent");
+  BOOST_CHECK_EQUAL(&sent, &registry.GetCounter("sent"));
+  BOOST_CHECK_EQUAL(registry.Counters().size(), 1U);
+  int depth = 4;
+  registry.AddGauge("depth", [&depth] { return depth; });
+  registry.GetHistogram("delay", {1, 10, 100}).Record(5);
+
+  registry.Sample(100000);
+  sent++;
+  depth = 1;
+  registry.Sample(200000);
+  sent++;
+
+  MetricsExporter::Instance().Close();
+  BOOST_CHECK(!MetricsExporter::Instance().Enabled());
+
+  std::string json = ReadFile(prefix + ".json");
+  BOOST_CHECK(json.find("\"source\": 7") != std::string::npos);
+  BOOST_CHECK(json.find("\"columns\": [\"sent\", \"depth\"]") != std::string::npos);
+  BOOST_CHECK(json.find("[100000, 0, 4], [200000, 1, 1]") != std::string::npos);
+  BOOST_CHECK(json.find("\"totals\": {\"sent\": 2}") != std::string::npos);
+  BOOST_CHECK(json.find("\"delay\": {\"bounds\": [1, 10, 100]") != std::string::npos);
+  BOOST_CHECK(json.find("\"merged\": {\n\"delay\": {") != std::string::npos);
+  BOOST_CHECK(json.find("\"counts\": [0, 1, 1, 0], \"count\": 2, \"sum\": 55") !=
+              std::string::npos);
+
+  std::string csv = ReadFile(prefix + ".csv");
+  BOOST_CHECK_EQUAL(csv.substr(0, csv.find('\n')), "source,time_us,metric,value");
+  BOOST_CHECK(csv.find("7,0,sent,2\n") != std::string::npos);
+  BOOST_CHECK(csv.find("3,200000,depth,1\n") != std::string::npos);
+
+  std::remove((prefix + ".json").c_str());
+  std::remove((prefix + ".csv").c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
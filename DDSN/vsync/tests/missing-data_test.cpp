@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <tuple>
+#include <vector>
+
+#include "missing-data.hpp"
+
+using ndn::vsync::MissingDataTracker;
+using ndn::vsync::NodeID;
+
+BOOST_AUTO_TEST_SUITE(TestMissingData);
+
+BOOST_AUTO_TEST_CASE(Ranges) {
+  MissingDataTracker t;
+  BOOST_TEST(t.empty());
+  t.Insert(5, 1, 1000);
+  t.Insert(5, 990, 1010);
+  t.Insert(3, 7, 8);
+  t.Insert(3, 9, 8);  /* Empty range */
+  BOOST_CHECK_EQUAL(t.size(), 1012U);
+  BOOST_CHECK_EQUAL(t.NumRanges(), 2U);
+  BOOST_TEST(t.Contains(5, 1010));
+  BOOST_TEST(!t.Contains(5, 1011));
+  BOOST_TEST(!t.Contains(4, 1));
+
+  /* Punching a hole splits the range */
+  BOOST_TEST(t.Erase(5, 500));
+  BOOST_TEST(!t.Erase(5, 500));
+  BOOST_CHECK_EQUAL(t.size(), 1011U);
+  BOOST_CHECK_EQUAL(t.NumRanges(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(Next) {
+  MissingDataTracker t;
+  t.Insert(5, 2, 3);
+  t.Insert(3, 7, 7);
+
+  NodeID nid;
+  uint64_t seq;
+  BOOST_TEST(t.Next(nid, seq));
+  BOOST_CHECK_EQUAL(nid, 3U);
+  BOOST_CHECK_EQUAL(seq, 7U);
+  BOOST_TEST(t.Next(nid, seq));
+  BOOST_CHECK_EQUAL(nid, 5U);
+  BOOST_CHECK_EQUAL(seq, 2U);
+  BOOST_TEST(t.Next(nid, seq));
+  BOOST_CHECK_EQUAL(seq, 3U);
+  BOOST_TEST(!t.Next(nid, seq));
+  BOOST_TEST(t.empty());
+  BOOST_CHECK_EQUAL(t.NumRanges(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(RoundRobin) {
+  MissingDataTracker t;
+  t.Insert(1, 0, 99);
+  t.Insert(2, 0, 0);
+  t.Insert(3, 5, 5);
+
+  /* The long gap of producer 1 does not hold back 2 and 3 */
+  std::vector<std::pair<NodeID, uint64_t>> order;
+  NodeID nid;
+  uint64_t seq;
+  for (int i = 0; i < 5 && t.Next(nid, seq); ++i)
+    order.emplace_back(nid, seq);
+  std::vector<std::pair<NodeID, uint64_t>> expected = {{1, 0}, {2, 0}, {3, 5}, {1, 1}, {1, 2}};
+  BOOST_TEST((order == expected));
+
+  t.Insert(2, 10, 19);
+  t.Insert(3, 10, 19);
+  uint64_t first, last;
+  BOOST_TEST(t.NextRange(4, 8, nid, first, last));
+  BOOST_CHECK_EQUAL(nid, 2U);
+  BOOST_TEST(t.NextRange(4, 8, nid, first, last));
+  BOOST_CHECK_EQUAL(nid, 3U);
+  BOOST_TEST(t.NextRange(4, 8, nid, first, last));
+  BOOST_CHECK_EQUAL(nid, 1U);
+  BOOST_CHECK_EQUAL(first, 3U);
+}
+
+BOOST_AUTO_TEST_CASE(NextRange) {
+  MissingDataTracker t;
+  t.Insert(3, 1, 2);
+  t.Insert(5, 10, 19);
+  t.Insert(5, 30, 100);
+
+  NodeID nid;
+  uint64_t first, last;
+  BOOST_TEST(t.NextRange(2, 8, nid, first, last));
+  BOOST_CHECK_EQUAL(nid, 5U);
+  BOOST_CHECK_EQUAL(first, 10U);
+  BOOST_CHECK_EQUAL(last, 17U);
+  BOOST_CHECK_EQUAL(t.size(), 75U);
+  BOOST_TEST(!t.Contains(5, 17));
+  BOOST_TEST(t.Contains(5, 18));
+
+  /* The rest of the gap is now too short */
+  BOOST_TEST(t.NextRange(2, 100, nid, first, last));
+  BOOST_CHECK_EQUAL(first, 30U);
+  BOOST_CHECK_EQUAL(last, 100U);
+  BOOST_TEST(!t.NextRange(2, 100, nid, first, last));
+  BOOST_CHECK_EQUAL(t.size(), 4U);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachRange) {
+  MissingDataTracker t;
+  t.Insert(5, 1, 10);
+  t.Erase(5, 4);
+  t.Insert(3, 7, 7);
+  std::vector<std::tuple<NodeID, uint64_t, uint64_t>> ranges;
+  t.ForEachRange([&ranges] (NodeID nid, uint64_t first, uint64_t last) {
+    ranges.emplace_back(nid, first, last);
+  });
+  std::vector<std::tuple<NodeID, uint64_t, uint64_t>> expected = {
+    std::make_tuple(3, 7, 7), std::make_tuple(5, 1, 3), std::make_tuple(5, 5, 10)
+  };
+  BOOST_CHECK(ranges == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "mobility/mobility-generator.hpp"
+
+namespace mobility = ndn::mobility;
+
+namespace {
+
+mobility::GeneratorConfig
+Config(mobility::GeneratorConfig::Model model) {
+  mobility::GeneratorConfig config;
+  config.model = model;
+  config.nodes = 40;
+  config.duration = 600;
+  config.pause = 5;
+  config.random_pause = true;
+  config.seed = 7;
+  return config;
+}
+
+bool
+Same(const mobility::WaypointTable& a, const mobility::WaypointTable& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].size() != b[i].size())
+      return false;
+    for (size_t k = 0; k < a[i].size(); ++k) {
+      if (a[i][k].t != b[i][k].t || a[i][k].x != b[i][k].x || a[i][k].y != b[i][k].y)
+        return false;
+    }
+  }
+  return true;
+}
+
+/* Inside the area, covering the duration, never faster than max_speed */
+void
+CheckPaths(const mobility::GeneratorConfig& config, const mobility::WaypointTable& table) {
+  for (const auto& path : table) {
+    BOOST_REQUIRE(!path.empty());
+    BOOST_CHECK_EQUAL(path.front().t, 0);
+    BOOST_CHECK_GE(path.back().t, config.duration);
+    for (size_t k = 0; k < path.size(); ++k) {
+      BOOST_CHECK(path[k].x >= 0 && path[k].x <= config.width);
+      BOOST_CHECK(path[k].y >= 0 && path[k].y <= config.height);
+      if (k == 0)
+        continue;
+      double dt = path[k].t - path[k - 1].t;
+      BOOST_REQUIRE_GT(dt, 0);
+      double distance = std::hypot(path[k].x - path[k - 1].x, path[k].y - path[k - 1].y);
+      if (config.model != mobility::GeneratorConfig::kGroup)
+        BOOST_CHECK_LE(distance / dt, config.max_speed * (1 + 1e-9));
+    }
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestMobilityGenerator);
+
+BOOST_AUTO_TEST_CASE(Deterministic) {
+  mobility::GeneratorConfig config = Config(mobility::GeneratorConfig::kWaypoint);
+  mobility::WaypointTable one = mobility::Generate(config, 1);
+  BOOST_CHECK(Same(one, mobility::Generate(config, 4)));
+
+  /* A node's path does not depend on how many nodes there are */
+  config.nodes = 10;
+  mobility::WaypointTable fewer = mobility::Generate(config, 3);
+  one.resize(10);
+  BOOST_CHECK(Same(one, fewer));
+
+  config.seed = 8;
+  BOOST_CHECK(!Same(one, mobility::Generate(config, 1)));
+}
+
+BOOST_AUTO_TEST_CASE(RandomWaypoint) {
+  mobility::GeneratorConfig config = Config(mobility::GeneratorConfig::kWaypoint);
+  CheckPaths(config, mobility::Generate(config, 2));
+}
+
+BOOST_AUTO_TEST_CASE(Manhattan) {
+  mobility::GeneratorConfig config = Config(mobility::GeneratorConfig::kManhattan);
+  mobility::WaypointTable table = mobility::Generate(config, 2);
+  CheckPaths(config, table);
+
+  /* Block by block along the streets */
+  for (const auto& path : table) {
+    for (size_t k = 0; k < path.size(); ++k) {
+      BOOST_CHECK_EQUAL(std::fmod(path[k].x, config.block), 0);
+      BOOST_CHECK_EQUAL(std::fmod(path[k].y, config.block), 0);
+      if (k > 0) {
+        double distance = std::fabs(path[k].x - path[k - 1].x) +
+                          std::fabs(path[k].y - path[k - 1].y);
+        BOOST_CHECK(distance == 0 || distance == config.block);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Group) {
+  mobility::GeneratorConfig config = Config(mobility::GeneratorConfig::kGroup);
+  mobility::WaypointTable table = mobility::Generate(config, 2);
+  CheckPaths(config, table);
+
+  /* Members of a group share waypoint times and stay close together */
+  for (size_t i = 0; i < table.size(); ++i) {
+    const auto& leader = table[i - i % config.group_size];
+    BOOST_REQUIRE_EQUAL(table[i].size(), leader.size());
+    for (size_t k = 0; k < leader.size(); ++k) {
+      BOOST_CHECK_EQUAL(table[i][k].t, leader[k].t);
+      BOOST_CHECK_LE(std::hypot(table[i][k].x - leader[k].x, table[i][k].y - leader[k].y),
+                     2 * config.group_radius);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Ns2RoundTrip) {
+  mobility::GeneratorConfig config = Config(mobility::GeneratorConfig::kWaypoint);
+  config.nodes = 3;
+  mobility::WaypointTable table = mobility::Generate(config, 1);
+  std::string text;
+  for (uint32_t node = 0; node < table.size(); ++node)
+    text += mobility::FormatNs2(node, table[node]);
+
+  std::istringstream in(text);
+  mobility::WaypointTable parsed;
+  std::string error;
+  BOOST_REQUIRE(mobility::ParseNs2(in, parsed, error));
+  BOOST_REQUIRE_EQUAL(parsed.size(), table.size());
+
+  /* Pauses are implicit in the trace; the parsed path visits the same places */
+  for (size_t i = 0; i < table.size(); ++i) {
+    const auto& path = table[i];
+    size_t k = 0;
+    for (const auto& w : parsed[i]) {
+      while (k + 1 < path.size() && path[k + 1].t <= w.t + 1e-6)
+        ++k;
+      BOOST_CHECK_CLOSE(w.x + 1, path[k].x + 1, 1e-6);
+      BOOST_CHECK_CLOSE(w.y + 1, path[k].y + 1, 1e-6);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
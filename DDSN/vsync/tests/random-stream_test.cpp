@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "random-stream.hpp"
+
+using ndn::vsync::RandomStream;
+
+namespace {
+
+std::vector<int>
+Draw(RandomStream& stream, size_t n) {
+  std::uniform_int_distribution<> dist(0, 1000000);
+  std::vector<int> values;
+  for (size_t i = 0; i < n; ++i)
+    values.push_back(dist(stream));
+  return values;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestRandomStream);
+
+BOOST_AUTO_TEST_CASE(Seeds) {
+  uint64_t seed = RandomStream::Seed(1, 3, 7, RandomStream::kPacket);
+  BOOST_CHECK_EQUAL(seed, RandomStream::Seed(1, 3, 7, RandomStream::kPacket));
+  BOOST_CHECK_NE(seed, RandomStream::Seed(1, 4, 7, RandomStream::kPacket));
+  BOOST_CHECK_NE(seed, RandomStream::Seed(1, 3, 8, RandomStream::kPacket));
+  BOOST_CHECK_NE(seed, RandomStream::Seed(1, 3, 7, RandomStream::kRetx));
+  BOOST_CHECK_NE(seed, RandomStream::Seed(2, 3, 7, RandomStream::kPacket));
+  /* Run and node must not be interchangeable */
+  BOOST_CHECK_NE(RandomStream::Seed(1, 3, 7, 0), RandomStream::Seed(1, 7, 3, 0));
+}
+
+BOOST_AUTO_TEST_CASE(Reproducible) {
+  RandomStream a(RandomStream::Seed(1, 0, 5, RandomStream::kAck));
+  RandomStream b(RandomStream::Seed(1, 0, 5, RandomStream::kAck));
+  RandomStream c(RandomStream::Seed(1, 1, 5, RandomStream::kAck));
+  std::vector<int> values = Draw(a, 100);
+  BOOST_CHECK(values == Draw(b, 100));
+  BOOST_CHECK(values != Draw(c, 100));
+  BOOST_CHECK_EQUAL(a.Draws(), 100U);
+
+  a.Reset();
+  BOOST_CHECK_EQUAL(a.Draws(), 0U);
+  BOOST_CHECK(values == Draw(a, 100));
+}
+
+BOOST_AUTO_TEST_CASE(SaveRestore) {
+  RandomStream stream(42);
+  Draw(stream, 10);
+  std::string state = stream.Save();
+  std::vector<int> values = Draw(stream, 50);
+
+  RandomStream other(7);
+  BOOST_REQUIRE(other.Restore(state));
+  BOOST_CHECK_EQUAL(other.GetSeed(), 42U);
+  BOOST_CHECK_EQUAL(other.Draws(), 10U);
+  BOOST_CHECK(values == Draw(other, 50));
+
+  BOOST_CHECK(!other.Restore("42 10"));
+  BOOST_CHECK_EQUAL(other.Draws(), 60U);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
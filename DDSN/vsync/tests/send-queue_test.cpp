@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "send-queue.hpp"
+
+using ndn::Data;
+using ndn::Interest;
+using ndn::Name;
+using ndn::vsync::Packet;
+using ndn::vsync::PacketQueue;
+using ndn::vsync::SendQueue;
+
+namespace {
+
+Packet MakeInterestPacket(int id,
+                          Packet::SourceType origin = Packet::ORIGINAL) {
+  Packet packet;
+  packet.interest = std::make_shared<Interest>(Name().appendNumber(id));
+  packet.packet_type = Packet::INTEREST_TYPE;
+  packet.packet_origin = origin;
+  packet.nRetries = id;   /* Used as a tag */
+  return packet;
+}
+
+/* Sizes for DRR, so that packets need not be signed to be wire encoded */
+size_t TestPacketSize(const Packet& packet) {
+  return packet.packet_type == Packet::DATA_TYPE ? 100 : 40;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestSendQueue);
+
+BOOST_AUTO_TEST_CASE(StrictPriority) {
+  SendQueue q;
+  q.Push(SendQueue::kDataInterest, MakeInterestPacket(1), 0);
+  q.Push(SendQueue::kSyncInterest, MakeInterestPacket(2), 0);
+  q.Push(SendQueue::kSyncReply, MakeInterestPacket(3), 0);
+
+  Packet packet;
+  SendQueue::Type type;
+  BOOST_TEST(q.Pop(10, packet, type));
+  BOOST_CHECK_EQUAL(type, SendQueue::kSyncReply);
+  BOOST_CHECK_EQUAL(packet.nRetries, 3);
+  BOOST_TEST(q.Pop(10, packet, type));
+  BOOST_CHECK_EQUAL(type, SendQueue::kSyncInterest);
+  BOOST_TEST(q.Pop(20, packet, type));
+  BOOST_CHECK_EQUAL(type, SendQueue::kDataInterest);
+  BOOST_TEST(!q.Pop(20, packet, type));
+  BOOST_TEST(q.Empty());
+
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kDataInterest).dequeued, 1U);
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kDataInterest).total_wait, 20);
+}
+
+BOOST_AUTO_TEST_CASE(Limits) {
+  SendQueue q;
+  q.SetLimit(SendQueue::kSyncInterest, 1, SendQueue::kDropHead);
+  q.SetLimit(SendQueue::kDataInterest, 2, SendQueue::kDropTail);
+
+  q.Push(SendQueue::kSyncInterest, MakeInterestPacket(1), 0);
+  BOOST_TEST(q.Push(SendQueue::kSyncInterest, MakeInterestPacket(2), 0));
+  BOOST_CHECK_EQUAL(q.Size(SendQueue::kSyncInterest), 1U);
+  BOOST_CHECK_EQUAL(q.Queue(SendQueue::kSyncInterest).front().nRetries, 2);
+
+  q.Push(SendQueue::kDataInterest, MakeInterestPacket(1), 0);
+  q.Push(SendQueue::kDataInterest, MakeInterestPacket(2), 0);
+  BOOST_TEST(!q.Push(SendQueue::kDataInterest, MakeInterestPacket(3), 0));
+  BOOST_CHECK_EQUAL(q.Size(SendQueue::kDataInterest), 2U);
+  BOOST_CHECK_EQUAL(q.Queue(SendQueue::kDataInterest).back().nRetries, 2);
+
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kSyncInterest).dropped, 1U);
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kDataInterest).dropped, 1U);
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kDataInterest).max_depth, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(WeightedRoundRobin) {
+  SendQueue q;
+  q.SetScheduling(SendQueue::kWeightedRoundRobin);
+  q.SetWeight(SendQueue::kSyncReply, 2);
+  q.SetWeight(SendQueue::kDataInterest, 1);
+  for (int i = 0; i < 4; ++i) {
+    q.Push(SendQueue::kSyncReply, MakeInterestPacket(i), 0);
+    q.Push(SendQueue::kDataInterest, MakeInterestPacket(i), 0);
+  }
+
+  std::vector<SendQueue::Type> order;
+  Packet packet;
+  SendQueue::Type type;
+  while (q.Pop(0, packet, type))
+    order.push_back(type);
+
+  /* Low priority level is not starved */
+  std::vector<SendQueue::Type> expected = {
+    SendQueue::kDataInterest,
+    SendQueue::kSyncReply, SendQueue::kSyncReply,
+    SendQueue::kDataInterest,
+    SendQueue::kSyncReply, SendQueue::kSyncReply,
+    SendQueue::kDataInterest, SendQueue::kDataInterest
+  };
+  BOOST_TEST(order == expected);
+}
+
+BOOST_AUTO_TEST_CASE(DeficitRoundRobin) {
+  SendQueue q;
+  q.SetScheduling(SendQueue::kDeficitRoundRobin);
+  q.SetQuantum(100);
+  q.SetPacketSize(TestPacketSize);
+  q.SetWeight(SendQueue::kDataReply, 1);
+  q.SetWeight(SendQueue::kDataInterest, 1);
+
+  Packet big;
+  big.data = std::make_shared<Data>();
+  big.packet_type = Packet::DATA_TYPE;
+  q.Push(SendQueue::kDataReply, big, 0);
+  q.Push(SendQueue::kDataReply, big, 0);
+  q.Push(SendQueue::kDataInterest, MakeInterestPacket(1), 0);
+  q.Push(SendQueue::kDataInterest, MakeInterestPacket(2), 0);
+
+  /* Each quantum covers one data or two interests */
+  std::vector<SendQueue::Type> order;
+  Packet packet;
+  SendQueue::Type type;
+  while (q.Pop(0, packet, type))
+    order.push_back(type);
+  std::vector<SendQueue::Type> expected = {
+    SendQueue::kDataReply,
+    SendQueue::kDataInterest, SendQueue::kDataInterest,
+    SendQueue::kDataReply
+  };
+  BOOST_TEST(order == expected);
+}
+
+BOOST_AUTO_TEST_CASE(InfRetxUnderAckLoad) {
+  /* The weights and quantum of Node */
+  const size_t weights[SendQueue::kNumTypes] = {4, 4, 1, 4, 1};
+  Packet ack;
+  ack.data = std::make_shared<Data>();
+  ack.packet_type = Packet::DATA_TYPE;
+
+  for (auto scheduling : {SendQueue::kStrictPriority, SendQueue::kDeficitRoundRobin}) {
+    SendQueue q;
+    q.SetScheduling(scheduling);
+    q.SetQuantum(4000);
+    q.SetPacketSize(TestPacketSize);
+    for (size_t i = 0; i < SendQueue::kNumTypes; ++i)
+      q.SetWeight(static_cast<SendQueue::Type>(i), weights[i]);
+    q.Push(SendQueue::kInfRetxDataInterest, MakeInterestPacket(1), 0);
+
+    /* An ACK arrives for every packet sent */
+    int served = -1;
+    Packet packet;
+    SendQueue::Type type;
+    for (int i = 0; i < 1000 && served < 0; ++i) {
+      q.Push(SendQueue::kSyncReply, ack, i);
+      BOOST_REQUIRE(q.Pop(i, packet, type));
+      if (type == SendQueue::kInfRetxDataInterest)
+        served = i;
+    }
+    if (scheduling == SendQueue::kStrictPriority)
+      BOOST_CHECK_EQUAL(served, -1);
+    else
+      BOOST_CHECK(served >= 0 && served <= 200);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(EraseByName) {
+  PacketQueue q;
+  for (int i = 0; i < 4; ++i)
+    q.push_back(MakeInterestPacket(i));
+  q.push_front(MakeInterestPacket(7, Packet::FORWARDED));
+
+  BOOST_TEST(q.Contains(Name().appendNumber(2)));
+  BOOST_TEST(!q.Contains(Name().appendNumber(7)));  /* Forwarded are not indexed */
+  BOOST_TEST(q.Erase(Name().appendNumber(2)));
+  BOOST_TEST(!q.Erase(Name().appendNumber(2)));
+  BOOST_CHECK_EQUAL(q.size(), 4U);
+
+  std::vector<int> order;
+  while (!q.empty())
+    order.push_back(q.pop_front().nRetries);
+  BOOST_TEST(order == std::vector<int>({7, 0, 1, 3}));
+  BOOST_TEST(!q.Contains(Name().appendNumber(0)));
+
+  SendQueue sq;
+  sq.SetLimit(SendQueue::kDataInterest, 1, SendQueue::kDropHead);
+  sq.Push(SendQueue::kDataInterest, MakeInterestPacket(1), 0);
+  sq.Push(SendQueue::kDataInterest, MakeInterestPacket(2), 0);
+  BOOST_TEST(!sq.Contains(SendQueue::kDataInterest, Name().appendNumber(1)));
+  BOOST_TEST(sq.Erase(SendQueue::kDataInterest, Name().appendNumber(2)));
+  BOOST_TEST(sq.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(Restore) {
+  SendQueue q;
+  q.SetLimit(SendQueue::kSyncInterest, 1, SendQueue::kDropHead);
+  Packet packet = MakeInterestPacket(1);
+  packet.enqueue_time = 5;
+  q.Restore(SendQueue::kSyncInterest, packet);
+  q.Restore(SendQueue::kSyncInterest, MakeInterestPacket(2));
+  BOOST_CHECK_EQUAL(q.Size(SendQueue::kSyncInterest), 2U);
+  BOOST_CHECK_EQUAL(q.Queue(SendQueue::kSyncInterest).front().enqueue_time, 5);
+  BOOST_TEST(q.Contains(SendQueue::kSyncInterest, Name().appendNumber(2)));
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kSyncInterest).enqueued, 0U);
+
+  q.SetStats(SendQueue::kSyncInterest, SendQueue::Stats{7, 5, 1, 2, 100});
+  SendQueue::Type type;
+  BOOST_TEST(q.Pop(15, packet, type));
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kSyncInterest).dequeued, 6U);
+  BOOST_CHECK_EQUAL(q.GetStats(SendQueue::kSyncInterest).total_wait, 110);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
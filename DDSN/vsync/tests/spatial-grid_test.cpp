@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "spatial/spatial-grid.hpp"
+
+using ndn::spatial::SpatialGrid;
+
+namespace {
+
+struct Point {
+  double x, y, vx, vy, t;
+};
+
+std::set<SpatialGrid::Id>
+Within(SpatialGrid& grid, double now, double x, double y, double radius) {
+  std::set<SpatialGrid::Id> ids;
+  grid.ForEachWithin(now, x, y, 0, radius, [&ids] (SpatialGrid::Id id) {
+    ids.insert(id);
+  });
+  return ids;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestSpatialGrid);
+
+BOOST_AUTO_TEST_CASE(StaticPoints) {
+  SpatialGrid grid(10);
+  grid.Update(0, 0, 0, 0, 0, 0, 0, 0);
+  grid.Update(1, 0, 9.5, 0, 0, 0, 0, 0);
+  grid.Update(2, 0, 10.5, 0, 0, 0, 0, 0);
+  grid.Update(3, 0, -3, -4, 0, 0, 0, 0);
+  BOOST_CHECK_EQUAL(grid.Size(), 4U);
+  BOOST_CHECK((Within(grid, 1, 0, 0, 10) == std::set<SpatialGrid::Id>{0, 1, 3}));
+  BOOST_CHECK_EQUAL(grid.CountWithin(1, 0, 0, 0, 5, 0), 1U);
+  BOOST_CHECK_EQUAL(grid.CountWithin(1, 0, 0, 0, 5 - 1e-9, 0), 0U);
+
+  grid.Remove(1);
+  grid.Remove(1);
+  BOOST_CHECK_EQUAL(grid.Size(), 3U);
+  BOOST_CHECK((Within(grid, 1, 10, 0, 1) == std::set<SpatialGrid::Id>{2}));
+}
+
+BOOST_AUTO_TEST_CASE(MovingPoints) {
+  /* Random course changes, compared with a scan of all points */
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<> pos(0, 800);
+  std::uniform_real_distribution<> vel(-20, 20);
+  const double kRange = 80;
+  SpatialGrid grid(kRange);
+  std::vector<Point> points(100);
+  for (size_t i = 0; i < points.size(); ++i) {
+    points[i] = {pos(rng), pos(rng), vel(rng), vel(rng), 0};
+    grid.Update(i, 0, points[i].x, points[i].y, 0, points[i].vx, points[i].vy, 0);
+  }
+
+  for (double now = 0.1; now < 60; now += 0.1) {
+    size_t moved = rng() % points.size();
+    Point& p = points[moved];
+    p.x += p.vx * (now - p.t);
+    p.y += p.vy * (now - p.t);
+    p.vx = vel(rng);
+    p.vy = vel(rng);
+    p.t = now;
+    grid.Update(moved, now, p.x, p.y, 0, p.vx, p.vy, 0);
+
+    size_t self = rng() % points.size();
+    double x = points[self].x + points[self].vx * (now - points[self].t);
+    double y = points[self].y + points[self].vy * (now - points[self].t);
+    size_t expected = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+      double dx = points[i].x + points[i].vx * (now - points[i].t) - x;
+      double dy = points[i].y + points[i].vy * (now - points[i].t) - y;
+      if (i != self && std::sqrt(dx * dx + dy * dy) <= kRange)
+        ++expected;
+    }
+    BOOST_REQUIRE_EQUAL(grid.CountWithin(now, x, y, 0, kRange, self), expected);
+  }
+  /* Points need at least 40 / (20 * sqrt(2)) seconds to drift half a cell */
+  BOOST_CHECK_GT(grid.Rebins(), 0U);
+  BOOST_CHECK_LT(grid.Rebins(), 200U);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
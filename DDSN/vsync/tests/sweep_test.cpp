@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sweep/sweep.hpp"
+
+namespace sweep = ndn::sweep;
+
+BOOST_AUTO_TEST_SUITE(TestSweep);
+
+BOOST_AUTO_TEST_CASE(ParseSpec) {
+  std::istringstream in(
+    "# Loss rates\n"
+    "command = ./build/sync-for-sleep-movepattern --eventLog={dir}/output.events\n"
+    "analyze = ./build/sync-analyzer {dir}/output.txt  # comment\n"
+    "env NS_LOG = SyncForSleep\n"
+    "\n"
+    "param lossRate = 0.0 0.05\n"
+    "param wifiRange = 60 80 100\n"
+    "seed run = 1-3 7\n");
+  sweep::SweepSpec spec;
+  std::string error;
+  BOOST_REQUIRE(sweep::ParseSpec(in, spec, error));
+  BOOST_CHECK_EQUAL(spec.analyze, "./build/sync-analyzer {dir}/output.txt");
+  BOOST_REQUIRE_EQUAL(spec.env.size(), 1U);
+  BOOST_CHECK_EQUAL(spec.env[0].second, "SyncForSleep");
+  BOOST_REQUIRE_EQUAL(spec.params.size(), 2U);
+  BOOST_CHECK_EQUAL(spec.params[1].second.size(), 3U);
+  BOOST_CHECK_EQUAL(spec.seed_name, "run");
+  std::vector<uint64_t> seeds = {1, 2, 3, 7};
+  BOOST_CHECK(spec.seeds == seeds);
+
+  std::vector<sweep::Point> points = sweep::ExpandPoints(spec);
+  BOOST_REQUIRE_EQUAL(points.size(), 6U);
+  BOOST_CHECK_EQUAL(points[1].Name(), "lossRate_0.0-wifiRange_80");
+  BOOST_CHECK_EQUAL(points[5].Args(), " --lossRate=0.05 --wifiRange=100");
+  BOOST_CHECK_EQUAL(sweep::SubstituteDir(spec.command, "out/a"),
+                    "./build/sync-for-sleep-movepattern --eventLog=out/a/output.events");
+}
+
+BOOST_AUTO_TEST_CASE(BadSpec) {
+  sweep::SweepSpec spec;
+  std::string error;
+  std::istringstream no_command("param lossRate = 0.1\n");
+  BOOST_CHECK(!sweep::ParseSpec(no_command, spec, error));
+  std::istringstream bad_seed("command = true\nseed run = 5-2\n");
+  BOOST_CHECK(!sweep::ParseSpec(bad_seed, spec, error));
+  BOOST_CHECK_EQUAL(error, "line 2: bad setting \"seed run = 5-2\"");
+
+  /* Without seeds every point runs once */
+  sweep::SweepSpec defaults;
+  std::istringstream minimal("command = true\n");
+  BOOST_REQUIRE(sweep::ParseSpec(minimal, defaults, error));
+  BOOST_CHECK_EQUAL(defaults.seed_name, "RngRun");
+  BOOST_CHECK_EQUAL(defaults.seeds.size(), 1U);
+  BOOST_CHECK_EQUAL(sweep::ExpandPoints(defaults).size(), 1U);
+  BOOST_CHECK_EQUAL(sweep::ExpandPoints(defaults)[0].Name(), "default");
+}
+
+BOOST_AUTO_TEST_CASE(ParseFlatJson) {
+  std::map<std::string, double> values = sweep::ParseFlatJson(
+    "{\n  \"data availability\": 0.95,\n  \"state sync delay\": null,\n"
+    "  \"out ack\": 1.5e+03\n}\n");
+  BOOST_CHECK_EQUAL(values.size(), 2U);
+  BOOST_CHECK_EQUAL(values["data availability"], 0.95);
+  BOOST_CHECK_EQUAL(values["out ack"], 1500);
+}
+
+BOOST_AUTO_TEST_CASE(Summarize) {
+  sweep::Summary summary = sweep::Summarize({2, 4, 4, 4, 5, 5, 7, 9});
+  BOOST_CHECK_EQUAL(summary.n, 8U);
+  BOOST_CHECK_EQUAL(summary.mean, 5);
+  BOOST_CHECK_CLOSE(summary.stddev, std::sqrt(32.0 / 7), 1e-9);
+  BOOST_CHECK_CLOSE(summary.ci95, 2.365 * summary.stddev / std::sqrt(8.0), 1e-9);
+
+  summary = sweep::Summarize({3});
+  BOOST_CHECK_EQUAL(summary.mean, 3);
+  BOOST_CHECK(std::isnan(summary.ci95));
+  BOOST_CHECK_EQUAL(sweep::StudentT95(100), 1.96);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
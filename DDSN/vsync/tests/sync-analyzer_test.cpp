@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "analyzer/sync-analyzer.hpp"
+
+namespace analyzer = ndn::analyzer;
+namespace eventlog = ndn::eventlog;
+
+namespace {
+
+const std::string kOutput =
+  "NFD: node(1) m_outNotifyInterest = 10\n"
+  "NFD: node(1) m_outData = 3\n"
+  "NFD: node(1) m_cacheHit = 2\n"
+  "NFD: node(1) m_cacheHitSpecial = 1\n"
+  "node(1) received_data_mobile = 4\n"
+  "node(1) received_data_mobile_from_repo = 1\n"
+  "PhyRxDropCount: 7\n"
+  "100 microseconds node(1) Store New Data: /a/1\n"
+  "+2.5s 1 SyncForSleep: Recv data reply: name=/a/1\n"
+  "node(2) hibernate_duration = 1.5\n"
+  "PhyRxDropCount: 9\n"
+  "300 microseconds node(2) Store New Data: /a/1\n"
+  "node(3) hibernate_duration = 2.5e+01";
+
+eventlog::EventRecord
+Record(int64_t time, uint64_t node, eventlog::EventType type, uint64_t producer, uint64_t seq) {
+  eventlog::EventRecord record = {time, node, producer, seq, 0, type, 0};
+  return record;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestSyncAnalyzer);
+
+BOOST_AUTO_TEST_CASE(ParseNumber) {
+  const char* s = "-1.5e+02";
+  BOOST_CHECK_EQUAL(analyzer::detail::ParseNumber(s, s + 8), -150);
+  s = "42\n";
+  BOOST_CHECK_EQUAL(analyzer::detail::ParseNumber(s, s + 3), 42);
+  s = "0.25";
+  BOOST_CHECK_EQUAL(analyzer::detail::ParseNumber(s, s + 4), 0.25);
+}
+
+BOOST_AUTO_TEST_CASE(ScanText) {
+  analyzer::TextStats stats;
+  analyzer::ScanText(kOutput.data(), kOutput.data() + kOutput.size(), analyzer::kDdsn, stats);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kOutNotifyInterest], 10);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kOutData], 3);
+  /* Substring semantics of syncDuration.py */
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kCacheHit], 3);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kCacheHitSpecial], 1);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kReceivedDataMobile], 5);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kReceivedDataMobileFromRepo], 1);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kPhyRxDropCount], 9);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kRecvDataReply], 1);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kHibernateDuration], 26.5);
+  BOOST_CHECK_EQUAL(stats.counters[analyzer::kHibernateDurationLines], 2);
+
+  BOOST_REQUIRE_EQUAL(stats.stores.size(), 2U);
+  BOOST_CHECK_EQUAL(stats.stores[0].time, 100);
+  BOOST_CHECK_EQUAL(std::string(stats.stores[0].key, stats.stores[0].key_len), "/a/1");
+  BOOST_CHECK(!stats.stores[0].is_state);
+}
+
+BOOST_AUTO_TEST_CASE(ChunksMatchWholeText) {
+  analyzer::TextStats whole;
+  const char* begin = kOutput.data();
+  const char* end = begin + kOutput.size();
+  analyzer::ScanText(begin, end, analyzer::kDdsn, whole);
+
+  for (size_t n = 1; n <= 8; ++n) {
+    std::vector<const char*> bounds = analyzer::SplitLines(begin, end, n);
+    BOOST_CHECK(bounds.size() >= 2 && bounds.size() <= n + 1);
+    analyzer::TextStats merged;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      BOOST_CHECK(i == 0 || bounds[i][-1] == '\n');
+      analyzer::TextStats chunk;
+      analyzer::ScanText(bounds[i], bounds[i + 1], analyzer::kDdsn, chunk);
+      merged.Merge(chunk);
+    }
+    BOOST_CHECK(merged.counters == whole.counters);
+    BOOST_CHECK_EQUAL(merged.stores.size(), whole.stores.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Availability) {
+  std::vector<eventlog::EventRecord> records;
+  /* Seq 1 reaches 3 nodes, seq 2 only 2 */
+  records.push_back(Record(1000000, 0, eventlog::kDataStore, 0, 1));
+  records.push_back(Record(1000000, 0, eventlog::kDataStore, 0, 2));
+  records.push_back(Record(2000000, 1, eventlog::kDataStore, 0, 1));
+  records.push_back(Record(2500000, 1, eventlog::kSendSyncInterest, 1, 0));
+  records.push_back(Record(3000000, 1, eventlog::kDataStore, 0, 2));
+  records.push_back(Record(4000000, 2, eventlog::kDataStore, 0, 1));
+  records.push_back(Record(5000000, 3, eventlog::kDataStore, 0, 1));
+  records.push_back(Record(1000000, 0, eventlog::kStateStore, 0, 1));
+  records.push_back(Record(1500000, 1, eventlog::kStateStore, 0, 1));
+
+  for (size_t shards = 1; shards <= 3; ++shards) {
+    analyzer::EventStats total(3, 2);
+    for (size_t shard = 0; shard < shards; ++shard) {
+      analyzer::EventStats stats(3, 2);
+      analyzer::ScanEvents(records.data(), records.size(), shard, shards, stats);
+      total.Merge(stats);
+    }
+    BOOST_CHECK_EQUAL(total.data.Produced(), 2U);
+    BOOST_REQUIRE_EQUAL(total.data.Durations().size(), 1U);
+    BOOST_CHECK_EQUAL(total.data.Durations()[0], 3);
+    BOOST_CHECK_EQUAL(total.data.MaxOwners(), 4U);
+    BOOST_REQUIRE_EQUAL(total.state.Durations().size(), 1U);
+    BOOST_CHECK_EQUAL(total.state.Durations()[0], 0.5);
+    BOOST_CHECK_EQUAL(total.sends[analyzer::kSendSyncInterest], 1);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+
+#include "version-vector.hpp"
+
+using ndn::vsync::NodeID;
+using ndn::vsync::VersionVector;
+
+BOOST_AUTO_TEST_SUITE(TestVersionVector);
+
+BOOST_AUTO_TEST_CASE(SetGet) {
+  VersionVector vv;
+  BOOST_TEST(vv.empty());
+  vv.Set(3, 10);
+  vv[70000]++;
+  BOOST_CHECK_EQUAL(vv.size(), 2U);
+  BOOST_CHECK_EQUAL(vv.Get(3), 10U);
+  BOOST_CHECK_EQUAL(vv.Get(70000), 1U);
+  BOOST_CHECK_EQUAL(vv.Get(4), 0U);
+  BOOST_TEST(!vv.Has(4));
+
+  /* Present with seq 0 is different from absent */
+  vv.Set(4, 0);
+  BOOST_TEST(vv.Has(4));
+  BOOST_CHECK_EQUAL(vv.size(), 3U);
+  vv.Erase(4);
+  BOOST_TEST(!vv.Has(4));
+  BOOST_CHECK_EQUAL(vv.Sum(), 11U);
+
+  std::map<NodeID, uint64_t> entries(vv.begin(), vv.end());
+  BOOST_TEST((entries == std::map<NodeID, uint64_t>{{3, 10}, {70000, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(Merge) {
+  VersionVector v1{{1, 5}, {2, 3}};
+  VersionVector v2{{2, 7}, {3, 1}, {1, 4}};
+  std::map<NodeID, std::pair<uint64_t, uint64_t>> advanced;
+  BOOST_TEST(v1.Merge(v2, [&advanced] (NodeID nid, uint64_t from, uint64_t to) {
+    advanced[nid] = std::make_pair(from, to);
+  }));
+  BOOST_TEST((v1 == VersionVector{{1, 5}, {2, 7}, {3, 1}}));
+  BOOST_CHECK_EQUAL(advanced.size(), 2U);
+  BOOST_CHECK_EQUAL(advanced[2].first, 3U);
+  BOOST_CHECK_EQUAL(advanced[3].first, 0U);
+  BOOST_TEST(!v1.Merge(v2));
+}
+
+BOOST_AUTO_TEST_CASE(IsNewerThan) {
+  VersionVector mine{{1, 5}, {2, 3}};
+  /* Producers missing from the other vector are not compared */
+  BOOST_TEST(!mine.IsNewerThan(VersionVector{{2, 3}}));
+  BOOST_TEST(mine.IsNewerThan(VersionVector{{1, 4}}));
+  BOOST_TEST(!mine.IsNewerThan(VersionVector{{1, 6}, {2, 3}, {9, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(Version) {
+  VersionVector vv{{1, 3}};
+  uint64_t v = vv.Version();
+  vv.Get(1);
+  vv.Has(2);
+  BOOST_CHECK_EQUAL(vv.Version(), v);
+
+  BOOST_TEST(!vv.Merge(VersionVector{{1, 2}}));
+  BOOST_CHECK_EQUAL(vv.Version(), v);
+  BOOST_TEST(vv.Merge(VersionVector{{1, 4}}));
+  BOOST_TEST(vv.Version() != v);
+
+  v = vv.Version();
+  vv[1]++;
+  BOOST_TEST(vv.Version() != v);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
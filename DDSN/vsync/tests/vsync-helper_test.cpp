@@ -2,6 +2,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+
 #include <ndn-cxx/util/digest.hpp>
 #include <ndn-cxx/name.hpp>
 
@@ -75,4 +77,79 @@ BOOST_AUTO_TEST_CASE(VIEncodeDecode) {
   BOOST_CHECK_EQUAL(p1.first, esn);
 }*/
 
+BOOST_AUTO_TEST_CASE(VVBinaryEncodeDecode) {
+  VersionVector v1{{1, 0}, {2, 5}, {300, 127}, {7, 128}, {0xfffffffffffeULL, 1ULL << 40}};
+  std::string out;
+  EncodeVVWithInterest(v1, [](uint64_t nid) { return nid % 2 == 0; }, out);
+
+  VersionVector v2;
+  std::vector<NodeID> nodes;
+  BOOST_TEST(DecodeVVWithInterest(reinterpret_cast<const uint8_t*>(out.data()), out.size(),
+                                  v2, nodes));
+  BOOST_TEST((v2 == v1));
+  std::set<NodeID> interested(nodes.begin(), nodes.end());
+  BOOST_TEST((interested == std::set<NodeID>{2, 300, 0xfffffffffffeULL}));
+
+  /* Truncated buffers fail to decode */
+  for (size_t len = 0; len < out.size(); ++len) {
+    BOOST_TEST(!DecodeVVWithInterest(reinterpret_cast<const uint8_t*>(out.data()), len,
+                                     v2, nodes));
+    BOOST_TEST(v2.empty());
+    BOOST_TEST(nodes.empty());
+  }
+
+  /* An empty vector is valid */
+  out.clear();
+  EncodeVVWithInterest(VersionVector(), [](uint64_t) { return true; }, out);
+  BOOST_TEST(DecodeVVWithInterest(reinterpret_cast<const uint8_t*>(out.data()), out.size(),
+                                  v2, nodes));
+  BOOST_TEST(v2.empty());
+}
+
+BOOST_AUTO_TEST_CASE(VVBinaryOverflow) {
+  /* The largest seq that fits, and one more octet or one more bit */
+  std::string max_seq = std::string("\x00\x01\x01\x01", 4) +
+                        std::string(9, '\xff') + '\x01';
+  VersionVector vv;
+  std::vector<NodeID> nodes;
+  auto decode = [&](const std::string& s) {
+    return DecodeVVWithInterest(reinterpret_cast<const uint8_t*>(s.data()), s.size(), vv, nodes);
+  };
+  std::string too_long = max_seq;
+  too_long.replace(too_long.size() - 1, 1, "\x81\x00");
+  std::string too_big = max_seq;
+  too_big.back() = '\x02';
+
+  /* 2^64 - 1 is kAbsent, never a seq */
+  BOOST_TEST(!decode(max_seq));
+  BOOST_TEST(!decode(too_long));
+  BOOST_TEST(!decode(too_big));
+
+  std::string out;
+  VersionVector v1{{1, VersionVector::kAbsent - 1}};
+  EncodeVVWithInterest(v1, [](uint64_t) { return false; }, out);
+  BOOST_TEST(decode(out));
+  BOOST_TEST((vv == v1));
+}
+
+BOOST_AUTO_TEST_CASE(VVBinaryInName) {
+  VersionVector v1{{1, 3}, {2, 4}};
+  std::string encoded;
+  EncodeVVWithInterest(v1, [](uint64_t) { return true; }, encoded);
+  auto n = MakeSyncNotifyName(1, encoded, 12345);
+  VersionVector v2;
+  std::vector<NodeID> nodes;
+  BOOST_TEST(DecodeVVWithInterest(ExtractEncodedVV(n), v2, nodes));
+  BOOST_TEST((v2 == v1));
+  BOOST_CHECK_EQUAL(nodes.size(), 2U);
+  BOOST_CHECK_EQUAL(ExtractNodeID(n), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(BundledDataName) {
+  auto n = MakeBundledDataName(7, 20, 35, 12345);
+  BOOST_CHECK_EQUAL(ExtractBundleNodeID(n), 7U);
+  BOOST_CHECK_EQUAL(ExtractBundleFirst(n), 20U);
+  BOOST_CHECK_EQUAL(ExtractBundleLast(n), 35U);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "mobility/waypoint-table.hpp"
+
+namespace mobility = ndn::mobility;
+
+namespace {
+
+const char kTrace[] =
+  "$node_(0) set X_ 0.0\n"
+  "$node_(0) set Y_ 0.0\n"
+  "$node_(1) set X_ 50.0\n"
+  "$node_(1) set Y_ 10.0\n"
+  "$ns_ at 0.0 \"$node_(0) setdest 30.0 40.0 10.0\"\n"
+  "$ns_ at 2.0 \"$node_(0) setdest 0.0 40.0 5.0\"\n"
+  "$ns_ at 20.0 \"$node_(0) setdest 0.0 0.0 4.0\"\n"
+  "$ns_ at 5.0 \"$node_(1) set X_ 60.0\"\n";
+
+void
+CheckWaypoint(const mobility::Waypoint& w, double t, double x, double y) {
+  BOOST_CHECK_CLOSE(w.t + 1, t + 1, 1e-9);
+  BOOST_CHECK_CLOSE(w.x + 1, x + 1, 1e-9);
+  BOOST_CHECK_CLOSE(w.y + 1, y + 1, 1e-9);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestWaypointTable);
+
+BOOST_AUTO_TEST_CASE(ParseNs2) {
+  std::istringstream in(kTrace);
+  mobility::WaypointTable table;
+  std::string error;
+  BOOST_REQUIRE(mobility::ParseNs2(in, table, error));
+  BOOST_REQUIRE_EQUAL(table.size(), 2U);
+
+  /* Redirected at 2s, before reaching (30, 40); arrives at (0, 40) and waits */
+  BOOST_REQUIRE_EQUAL(table[0].size(), 5U);
+  CheckWaypoint(table[0][0], 0, 0, 0);
+  CheckWaypoint(table[0][1], 2, 12, 16);
+  CheckWaypoint(table[0][2], 2 + std::sqrt(12 * 12 + 24 * 24) / 5.0, 0, 40);
+  CheckWaypoint(table[0][3], 20, 0, 40);
+  CheckWaypoint(table[0][4], 30, 0, 0);
+
+  /* Jumps at 5s, in kJumpTime */
+  BOOST_REQUIRE_EQUAL(table[1].size(), 3U);
+  CheckWaypoint(table[1][0], 0, 50, 10);
+  CheckWaypoint(table[1][1], 5, 50, 10);
+  CheckWaypoint(table[1][2], 5 + mobility::kJumpTime, 60, 10);
+
+  /* Strictly ascending times, as WaypointMobilityModel requires */
+  for (const auto& path : table) {
+    for (size_t k = 1; k < path.size(); ++k)
+      BOOST_CHECK_GT(path[k].t, path[k - 1].t);
+  }
+
+  std::istringstream bad("$ns_ at 1.0 \"$node_(0) setdest 1.0\"\n");
+  BOOST_CHECK(!mobility::ParseNs2(bad, table, error));
+  BOOST_CHECK_EQUAL(error.compare(0, 7, "line 1:"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FileRoundTrip) {
+  std::string base = "/tmp/waypoint-test-" + std::to_string(getpid());
+  std::string trace = base + ".ns_movements";
+  std::string path = base + ".wpt";
+  std::ofstream(trace.c_str()) << kTrace;
+
+  std::istringstream in(kTrace);
+  mobility::WaypointTable table;
+  std::string error;
+  BOOST_REQUIRE(mobility::ParseNs2(in, table, error));
+  uint64_t size, hash;
+  BOOST_REQUIRE(mobility::HashFile(trace, size, hash));
+  BOOST_CHECK_EQUAL(size, sizeof(kTrace) - 1);
+  BOOST_REQUIRE(mobility::WriteTable(path, table, size, hash));
+
+  {
+    mobility::WaypointFile file;
+    BOOST_REQUIRE(file.Open(path, error));
+    BOOST_CHECK_EQUAL(file.Nodes(), 2U);
+    BOOST_CHECK_EQUAL(file.Waypoints(), 8U);
+    BOOST_REQUIRE_EQUAL(file.End(0) - file.Begin(0), 5);
+    CheckWaypoint(file.Begin(0)[4], 30, 0, 0);
+    CheckWaypoint(*file.Begin(1), 0, 50, 10);
+    BOOST_CHECK(file.MatchesSource(trace));
+
+    /* A trace edited after the conversion */
+    std::ofstream(trace.c_str(), std::ios::app) << "$ns_ at 40.0 \"$node_(1) setdest 0.0 0.0 1.0\"\n";
+    BOOST_CHECK(!file.MatchesSource(trace));
+  }
+
+  /* Damaged table */
+  {
+    std::fstream f(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(-1, std::ios::end);
+    f.put('\x7f');
+  }
+  mobility::WaypointFile damaged;
+  BOOST_CHECK(!damaged.Open(path, error));
+  BOOST_CHECK_EQUAL(error, path + " is damaged");
+
+  mobility::WaypointFile missing;
+  BOOST_CHECK(!missing.Open(base + ".missing", error));
+
+  std::remove(trace.c_str());
+  std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
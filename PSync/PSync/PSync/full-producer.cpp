@@ -18,6 +18,7 @@
  **/
 
 #include "PSync/full-producer.hpp"
+#include "event-log/event-log.hpp"
 
 #include <ndn-cxx/util/logger.hpp>
 #include <ndn-cxx/util/segment-fetcher.hpp>
@@ -118,7 +119,7 @@ FullProducer::sendSyncInterest()
   options.maxTimeout = m_syncInterestLifetime;
 
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Sync Interest\n";
+  ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncInterest, 0, 0);
 
   m_fetcher = ndn::util::SegmentFetcher::start(m_face,
                                                syncInterest,
@@ -250,7 +251,7 @@ FullProducer::sendSyncData(const ndn::Name& name, const ndn::Block& block)
 
     NDN_LOG_DEBUG("Sending Sync Data");
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Sync Reply\n";
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncReply, 0, 0);
 
     // Send data after removing pending sync interest on face
     m_segmentPublisher.publish(name, dataName, block, m_syncReplyFreshness);
@@ -261,7 +262,7 @@ FullProducer::sendSyncData(const ndn::Name& name, const ndn::Block& block)
   else {
     NDN_LOG_DEBUG("Sending Sync Data");
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Sync Reply\n";
+    ndn::eventlog::LogEvent(now, m_nid, ndn::eventlog::kSendSyncReply, 0, 0);
     m_segmentPublisher.publish(name, dataName, block, m_syncReplyFreshness);
   }
 }
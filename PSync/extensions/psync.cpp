@@ -20,6 +20,7 @@
  */
 
 #include "psync.hpp"
+#include "event-log/event-log.hpp"
 
 #include <climits>
 #include <assert.h>
@@ -105,8 +106,7 @@ void
 PSync::sendDataInterest(const Name& data_name)
 {
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest: "
-            << data_name << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kSendDataInterest, data_name.toUri());
   
   Interest interest(data_name, time::milliseconds(5000));
 
@@ -135,8 +135,7 @@ PSync::onDataInterest(const Name& prefix, const Interest& interest)
     m_scheduler.scheduleEvent(time::milliseconds(delay),
                               [this, interest] {
       int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-      std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest "
-                << "(Forward): " << interest.getName() << std::endl;
+      eventlog::LogEvent(now, m_nid, eventlog::kSendDataInterest, interest.getName().toUri());
       Interest interest_new_nonce(interest);
       interest_new_nonce.refreshNonce();
       m_face.expressInterest(interest_new_nonce,
@@ -157,8 +156,7 @@ PSync::onDataInterest(const Name& prefix, const Interest& interest)
                               [this, interest] {
       int64_t now = ns3::Simulator::Now().GetMicroSeconds();
       m_face.put(*m_data_store[interest.getName()]);
-      std::cout << now << " microseconds node(" << m_nid <<  ") Send Data Reply: "
-                << m_data_store[interest.getName()]->getName() << std::endl;
+      eventlog::LogEvent(now, m_nid, eventlog::kSendDataReply, interest.getName().toUri());
     });
   }
 }
@@ -185,8 +183,8 @@ PSync::onDataTimeout(const Interest& interest, int nRetries,
                             [this, interest_new_nonce, nRetries, reason] {
     
     int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-    std::cout << now << " microseconds node(" << m_nid << ") Send Data Interest ("
-              << reason << "): " << interest_new_nonce.getName() << std::endl;
+    eventlog::LogEvent(now, m_nid, eventlog::kSendDataInterest,
+                      interest_new_nonce.getName().toUri());
     
     m_face.expressInterest(interest_new_nonce,
                            std::bind(&PSync::onDataReply, this, _1, _2),
@@ -241,8 +239,7 @@ PSync::doUpdate(const ndn::Name& prefix)
   m_data_store[data_name] = data;
   logStateStore(prefix, seqNo);
   logDataStore(data_name);
-  std::cout << now << " microseconds node(" << m_nid << ") Publish: " 
-            << data_name << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kPublish, m_nid, seqNo);
   
   // Schedule for next data publishing
   m_scheduler.scheduleEvent(ndn::time::milliseconds(m_data_generation_random()),
@@ -255,16 +252,15 @@ void
 PSync::logStateStore(const Name& prefix, uint64_t seqNo)
 {
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Update New Seq: "
-            << prefix << "/" << seqNo << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kStateStore,
+                     prefix.toUri() + "/" + std::to_string(seqNo));
 }
 
 void
 PSync::logDataStore(const Name& data_name)
 {
   int64_t now = ns3::Simulator::Now().GetMicroSeconds();
-  std::cout << now << " microseconds node(" << m_nid << ") Store New Data: "
-            << data_name << std::endl;
+  eventlog::LogEvent(now, m_nid, eventlog::kDataStore, data_name.toUri());
 }
 
 void
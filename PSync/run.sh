@@ -9,7 +9,7 @@ if [ $# -eq 1 ]; then
     LOSS_RATE=$1
 fi
 
-rm -f results/*.txt
+rm -f results/*.txt results/*.events*
 ./waf
 
 echo "Simulating loss rate = ${LOSS_RATE} ..."
@@ -17,6 +17,7 @@ echo "Simulating loss rate = ${LOSS_RATE} ..."
 for (( TIME=1; TIME<=$RUN_TIMES; TIME++ )); do
     ./scenarios/psync-mobile \
         --lossRate=${LOSS_RATE} \
+        --eventLog=results/result_${TIME}.events \
         >> results/result_${TIME}.txt &
     pids="$pids $!"
 done
@@ -8,6 +8,10 @@
 import os, sys
 import numpy as np
 
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             "..", "common", "event-log"))
+import event_log
+
 class DataInfo:
     def __init__(self, birth):
         self.GenerationTime = birth
@@ -18,8 +22,9 @@ class DataInfo:
 
 class SyncDuration:
     
-    def __init__(self, filename):
+    def __init__(self, filename, event_filename=None):
         self._filename = filename
+        self._event_filename = event_filename
         self._node_num = 20
         self._availability_threshold = int(self._node_num * 0.95)
         # self._availability_threshold = 2 
@@ -35,6 +40,8 @@ class SyncDuration:
 
     def run(self):
         self._getSyncDuration()
+        if self._event_filename is not None:
+            self._getEvents()
         self._printSyncDuration()
     
     def _getSyncDuration(self):
@@ -58,10 +65,30 @@ class SyncDuration:
                 #     print(line)
                 #     raise AssertionError()  # For debug
 
+    def _getEvents(self):
+        for time, node, event_type, key in event_log.read_events(self._event_filename):
+            if event_type == event_log.DATA_STORE:
+                self._storeData(time, key)
+            elif event_type == event_log.STATE_STORE:
+                self._storeState(time, key)
+            elif event_type == event_log.SEND_SYNC_INTEREST:
+                self._n_sync_interest += 1
+            elif event_type == event_log.SEND_SYNC_REPLY:
+                self._n_sync_reply += 1
+            elif event_type == event_log.SEND_DATA_INTEREST:
+                self._n_data_interest += 1
+            elif event_type == event_log.SEND_DATA_REPLY:
+                self._n_data_reply += 1
+
     def _processDataSyncDuration(self, line):
         elements = line.strip().split(' ')
-        time = elements[0]
-        data_name = elements[-1]
+        self._storeData(elements[0], elements[-1])
+
+    def _processStateSyncDuration(self, line):
+        elements = line.strip().split(' ')
+        self._storeState(elements[0], elements[-1])
+
+    def _storeData(self, time, data_name):
         if data_name not in self._data_store:
             self._data_store[data_name] = DataInfo(int(time))
         else:
@@ -76,10 +103,7 @@ class SyncDuration:
             cur_sync_duration = float(cur_sync_duration) / 1000000.0
             self._data_sync_duration.append(cur_sync_duration)
 
-    def _processStateSyncDuration(self, line):
-        elements = line.strip().split(' ')
-        time = elements[0]
-        data_name = elements[-1]
+    def _storeState(self, time, data_name):
         if data_name not in self._state_store:
             self._state_store[data_name] = DataInfo(int(time))
         else:
@@ -88,7 +112,7 @@ class SyncDuration:
         data_info = self._state_store[data_name]
         if data_info.Owner > self._node_num:
             print("DATA INFO: ")
-            print(line)
+            print(data_name)
             raise AssertionError()
         elif not data_info.Available and data_info.Owner >= self._availability_threshold:
             self._state_store[data_name].Available = True
@@ -135,5 +159,5 @@ class SyncDuration:
 
 
 if __name__ == "__main__":
-    sd = SyncDuration(sys.argv[1])
+    sd = SyncDuration(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else None)
     sd.run()
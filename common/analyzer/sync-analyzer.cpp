@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Compute the statistics of a simulation run as JSON, in place of
+ * syncDuration.py:
+ *
+ *   sync-analyzer [--profile=ddsn|chronosync|psync] [--nodes=N] [--threads=N]
+ *                 <output.txt> [<events file>]
+ *
+ * Keys are the labels syncDuration.py prints, one per line, so the result
+ * summaries in myrun.sh can grep either output.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "analyzer/sync-analyzer.hpp"
+
+using namespace ndn::analyzer;
+namespace eventlog = ndn::eventlog;
+
+namespace {
+
+/**
+ * @brief Read-only mapping of a whole file.
+ */
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0) {}
+
+  ~MappedFile() {
+    if (data_ != nullptr)
+      munmap(const_cast<char*>(data_), size_);
+  }
+
+  bool Open(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    size_ = ok ? st.st_size : 0;
+    if (ok && size_ > 0) {
+      void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      ok = data != MAP_FAILED;
+      if (ok) {
+        data_ = static_cast<const char*>(data);
+        madvise(data, size_, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+    return ok;
+  }
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data_;
+  size_t size_;
+};
+
+TextStats
+ScanTextParallel(const MappedFile& file, Profile profile, size_t threads) {
+  TextStats total;
+  if (file.size() == 0)
+    return total;
+  std::vector<const char*> bounds = SplitLines(file.begin(), file.end(), threads);
+  std::vector<TextStats> chunks(bounds.size() - 1);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    workers.emplace_back([&bounds, &chunks, i, profile] {
+      ScanText(bounds[i], bounds[i + 1], profile, chunks[i]);
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  for (const auto& chunk : chunks)
+    total.Merge(chunk);
+  return total;
+}
+
+bool
+ScanEventsParallel(const MappedFile& file, size_t threads, EventStats& total) {
+  const size_t kHeaderSize = sizeof(eventlog::kLogMagic) + 2 * sizeof(uint32_t);
+  uint32_t header[2];
+  if (file.size() < kHeaderSize ||
+      memcmp(file.begin(), eventlog::kLogMagic, sizeof(eventlog::kLogMagic)) != 0)
+    return false;
+  memcpy(header, file.begin() + sizeof(eventlog::kLogMagic), sizeof(header));
+  if (header[0] != eventlog::kLogVersion || header[1] != sizeof(eventlog::EventRecord))
+    return false;
+  auto records = reinterpret_cast<const eventlog::EventRecord*>(file.begin() + kHeaderSize);
+  size_t count = (file.size() - kHeaderSize) / sizeof(eventlog::EventRecord);
+
+  std::vector<EventStats> shards(threads, total);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([&shards, records, count, i, threads] {
+      ScanEvents(records, count, i, threads, shards[i]);
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  for (const auto& shard : shards)
+    total.Merge(shard);
+  return true;
+}
+
+class JsonWriter {
+ public:
+  JsonWriter() : first_(true) { printf("{"); }
+  ~JsonWriter() { printf("\n}\n"); }
+
+  void Add(const char* label, double value) {
+    printf("%s\n  \"%s\": ", first_ ? "" : ",", label);
+    if (std::isfinite(value))
+      printf("%.15g", value);
+    else
+      printf("null");
+    first_ = false;
+  }
+
+ private:
+  bool first_;
+};
+
+double
+Ratio(double a, double b) {
+  return b != 0 ? a / b : std::numeric_limits<double>::quiet_NaN();
+}
+
+void
+Usage(const char* program) {
+  fprintf(stderr, "usage: %s [--profile=ddsn|chronosync|psync] [--nodes=N] [--threads=N] "
+          "<output.txt> [<events file>]\n", program);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  Profile profile = kDdsn;
+  size_t nodes = 20;
+  size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--profile=ddsn")
+      profile = kDdsn;
+    else if (arg == "--profile=chronosync")
+      profile = kChronoSync;
+    else if (arg == "--profile=psync")
+      profile = kPSync;
+    else if (arg.compare(0, 8, "--nodes=") == 0)
+      nodes = std::strtoul(arg.c_str() + 8, nullptr, 10);
+    else if (arg.compare(0, 10, "--threads=") == 0)
+      threads = std::max(1UL, std::strtoul(arg.c_str() + 10, nullptr, 10));
+    else if (arg.compare(0, 2, "--") != 0)
+      paths.push_back(arg);
+    else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (paths.empty() || paths.size() > 2) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  /* Thresholds of syncDuration.py: DDSN uses 90% of its 20 sync nodes for
+   * data and of all nodes for states, ChronoSync and PSync 95% of 20 */
+  size_t data_threshold, state_threshold;
+  if (profile == kDdsn) {
+    data_threshold = static_cast<size_t>(0.9 * 20);
+    state_threshold = static_cast<size_t>(0.9 * nodes);
+  }
+  else {
+    data_threshold = state_threshold = static_cast<size_t>(0.95 * nodes);
+  }
+
+  MappedFile text;
+  if (!text.Open(paths[0])) {
+    fprintf(stderr, "Cannot read %s\n", paths[0].c_str());
+    return 1;
+  }
+  TextStats stats = ScanTextParallel(text, profile, threads);
+
+  EventStats events(data_threshold, state_threshold);
+  if (paths.size() > 1) {
+    MappedFile log;
+    if (!log.Open(paths[1]) || !ScanEventsParallel(log, threads, events)) {
+      fprintf(stderr, "Cannot read event log %s\n", paths[1].c_str());
+      return 1;
+    }
+  }
+  /* Stores of older runs are in the text, after the event log as in Python */
+  ScanStoreLines(stats.stores, events);
+
+  std::vector<double> c = stats.counters;
+  for (size_t i = kSendSyncInterest; i <= kSendDataReply; ++i)
+    c[i] += events.sends[i];
+  std::vector<double>& data_delays = events.data.Durations();
+  std::vector<double>& state_delays = events.state.Durations();
+  double availability = Ratio(data_delays.size(), events.data.Produced());
+
+  JsonWriter json;
+  json.Add("data availability", availability);
+  json.Add("state sync delay", Mean(state_delays));
+  json.Add("data sync delay", Mean(data_delays));
+  json.Add("data sync delay p50", Quantile(data_delays, 0.5));
+  json.Add("data sync delay p90", Quantile(data_delays, 0.9));
+  json.Add("data sync delay p99", Quantile(data_delays, 0.99));
+  json.Add("state sync delay p50", Quantile(state_delays, 0.5));
+  json.Add("state sync delay p90", Quantile(state_delays, 0.9));
+  json.Add("state sync delay p99", Quantile(state_delays, 0.99));
+
+  if (profile != kDdsn) {
+    json.Add("out notify interest", c[kSendSyncInterest]);
+    json.Add("out ack", c[kSendSyncReply]);
+    json.Add("out data interest", c[kSendDataInterest]);
+    json.Add("out data", c[kSendDataReply]);
+    if (profile == kChronoSync) {
+      json.Add("NFD out data interest", c[kOutDataInterest]);
+      json.Add("NFD out data reply", c[kOutData]);
+    }
+    json.Add("Number of app data produced", events.data.Produced());
+    return 0;
+  }
+
+  json.Add("out notify interest", c[kOutNotifyInterest]);
+  json.Add("out beacon", c[kOutBeacon]);
+  json.Add("out data interest", c[kOutDataInterest]);
+  json.Add("out bundled interest", c[kOutBundledInterest]);
+  json.Add("out data", c[kOutData]);
+  json.Add("out ack", c[kOutAck]);
+  json.Add("out bundled data", c[kOutBundledData]);
+  json.Add("cache hit", c[kCacheHit]);
+  json.Add("cache hit special", c[kCacheHitSpecial]);
+  json.Add("number of data available", data_delays.size());
+  json.Add("number of data produced", events.data.Produced());
+  json.Add("recvDataReply", c[kRecvDataReply]);
+  json.Add("recvForwardedDataReply", c[kRecvForwardedDataReply]);
+  json.Add("recvSuppressedDataReply", c[kRecvSuppressedDataReply]);
+  json.Add("number of collision", c[kPhyRxDropCount]);
+  json.Add("in notify interest", c[kReceivedSyncInterest]);
+  json.Add("suppressed notify interest", c[kSuppressedSyncInterest]);
+  json.Add("should receive interest", c[kShouldReceiveSyncInterest]);
+  json.Add("received interest", c[kReceivedSyncInterest]);
+  json.Add("collision rate", 1 - Ratio(c[kReceivedSyncInterest], c[kShouldReceiveSyncInterest]));
+  json.Add("data reply", c[kDataReply]);
+  json.Add("repo reply rate", Ratio(c[kReceivedDataMobileFromRepo], c[kReceivedDataMobile]));
+  json.Add("hibernate duration", Ratio(c[kHibernateDuration], c[kHibernateDurationLines]));
+  if (events.data.MaxOwners() > 20)
+    fprintf(stderr, "Warning: a data has %zu owners, more than the sync nodes\n",
+            events.data.MaxOwners());
+  return 0;
+}
@@ -0,0 +1,519 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Statistics of a simulation run, computed from its text output and binary
+ * event log. Same results as the syncDuration.py scripts, but the text is
+ * scanned in place in parallel chunks and the event log is sharded by item
+ * across threads, so neither copies a line nor allocates per record.
+ *
+ * The text rules copy the Python substring tests, including their overlaps
+ * (e.g. "m_cacheHit" also counts m_cacheHitSpecial lines), so the numbers
+ * stay comparable with earlier results.
+ */
+
+#ifndef SYNC_COMMON_SYNC_ANALYZER_HPP_
+#define SYNC_COMMON_SYNC_ANALYZER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "event-log/event-log.hpp"
+
+namespace ndn {
+namespace analyzer {
+
+enum Profile {
+  kDdsn,
+  kChronoSync,
+  kPSync
+};
+
+/* Text counters, in the order they are reported */
+enum Counter {
+  kOutNotifyInterest,
+  kOutBeacon,
+  kOutDataInterest,
+  kOutBundledInterest,
+  kOutData,
+  kOutAck,
+  kOutBundledData,
+  kCacheHit,
+  kCacheHitSpecial,
+  kRecvDataReply,
+  kRecvForwardedDataReply,
+  kRecvSuppressedDataReply,
+  kPhyRxDropCount,
+  kReceivedSyncInterest,
+  kSuppressedSyncInterest,
+  kShouldReceiveSyncInterest,
+  kDataReply,
+  kReceivedDataMobile,
+  kReceivedDataMobileFromRepo,
+  kHibernateDuration,
+  kHibernateDurationLines,
+  kSendSyncInterest,
+  kSendSyncReply,
+  kSendDataInterest,
+  kSendDataReply,
+  kNumCounters
+};
+
+/**
+ * @brief Line rule: if a line contains @p filter (if any) and @p needle, add
+ *        its last number to @p counter, or one for kCount, or keep the last
+ *        number for kLast.
+ */
+struct Rule {
+  enum Mode { kSum, kCount, kLast };
+  const char* filter;
+  const char* needle;
+  Counter counter;
+  Mode mode;
+};
+
+inline const std::vector<Rule>&
+Rules(Profile profile)
+{
+  /* DDSN/syncDuration.py */
+  static const std::vector<Rule> kDdsnRules = {
+    {"NFD:", "m_outNotifyInterest", kOutNotifyInterest, Rule::kSum},
+    {"NFD:", "m_outBeacon", kOutBeacon, Rule::kSum},
+    {"NFD:", "m_outDataInterest", kOutDataInterest, Rule::kSum},
+    {"NFD:", "m_outBundledInterest", kOutBundledInterest, Rule::kSum},
+    {"NFD:", "m_outData =", kOutData, Rule::kSum},
+    {"NFD:", "m_outAck", kOutAck, Rule::kSum},
+    {"NFD:", "m_outBundledData", kOutBundledData, Rule::kSum},
+    {nullptr, "m_cacheHit", kCacheHit, Rule::kSum},
+    {nullptr, "m_cacheHitSpecial", kCacheHitSpecial, Rule::kSum},
+    {nullptr, "received_sync_interest", kReceivedSyncInterest, Rule::kSum},
+    {nullptr, "suppressed_sync_interest", kSuppressedSyncInterest, Rule::kSum},
+    {nullptr, "PhyRxDropCount", kPhyRxDropCount, Rule::kLast},
+    {nullptr, "Recv data reply", kRecvDataReply, Rule::kCount},
+    {nullptr, "Recv forwarded data reply", kRecvForwardedDataReply, Rule::kCount},
+    {nullptr, "Recv suppressed data reply", kRecvSuppressedDataReply, Rule::kCount},
+    {nullptr, "should_receive_sync_interest", kShouldReceiveSyncInterest, Rule::kSum},
+    {nullptr, "data_reply", kDataReply, Rule::kSum},
+    {nullptr, "received_data_mobile", kReceivedDataMobile, Rule::kSum},
+    {nullptr, "received_data_mobile_from_repo", kReceivedDataMobileFromRepo, Rule::kSum},
+    {nullptr, "hibernate_duration", kHibernateDuration, Rule::kSum},
+    {nullptr, "hibernate_duration", kHibernateDurationLines, Rule::kCount},
+  };
+  /* ChronoSync/syncDuration.py. Sends in the event log are added to these */
+  static const std::vector<Rule> kChronoSyncRules = {
+    {nullptr, "Send Sync Interest", kSendSyncInterest, Rule::kCount},
+    {nullptr, "Send Sync Reply", kSendSyncReply, Rule::kCount},
+    {nullptr, "Send Data Interest", kSendDataInterest, Rule::kCount},
+    {nullptr, "Send Data Reply", kSendDataReply, Rule::kCount},
+    {nullptr, "m_outDataInterest", kOutDataInterest, Rule::kSum},
+    {nullptr, "m_outData ", kOutData, Rule::kSum},
+  };
+  /* PSync/syncDuration.py */
+  static const std::vector<Rule> kPSyncRules = {
+    {"microseconds", "Send Sync Interest", kSendSyncInterest, Rule::kCount},
+    {"microseconds", "Send Sync Reply", kSendSyncReply, Rule::kCount},
+    {"microseconds", "Send Data Interest", kSendDataInterest, Rule::kCount},
+    {"microseconds", "Send Data Reply", kSendDataReply, Rule::kCount},
+  };
+  switch (profile) {
+    case kChronoSync:
+      return kChronoSyncRules;
+    case kPSync:
+      return kPSyncRules;
+    default:
+      return kDdsnRules;
+  }
+}
+
+/**
+ * @brief "Store New Data" or "Update New Seq" line of an older text-only
+ *        run. Points into the scanned text.
+ */
+struct StoreLine {
+  int64_t time;
+  const char* key;
+  uint32_t key_len;
+  bool is_state;
+};
+
+struct TextStats {
+  TextStats() : counters(kNumCounters, 0), has_last(kNumCounters, false) {}
+
+  std::vector<double> counters;
+  std::vector<bool> has_last;       /* For kLast counters */
+  std::vector<StoreLine> stores;    /* In text order */
+
+  /**
+   * @brief Fold in the stats of the text following this one.
+   */
+  void
+  Merge(const TextStats& next)
+  {
+    for (size_t i = 0; i < counters.size(); ++i) {
+      if (next.has_last[i]) {
+        counters[i] = next.counters[i];
+        has_last[i] = true;
+      }
+      else if (!has_last[i]) {
+        counters[i] += next.counters[i];
+      }
+    }
+    stores.insert(stores.end(), next.stores.begin(), next.stores.end());
+  }
+};
+
+namespace detail {
+
+inline bool
+Contains(const char* begin, const char* end, const char* needle, size_t len)
+{
+  if (static_cast<size_t>(end - begin) < len)
+    return false;
+  const char* last = end - len;
+  for (const char* p = begin; p <= last; ++p) {
+    p = static_cast<const char*>(memchr(p, needle[0], last - p + 1));
+    if (p == nullptr)
+      return false;
+    if (memcmp(p, needle, len) == 0)
+      return true;
+  }
+  return false;
+}
+
+inline bool
+Contains(const char* begin, const char* end, const char* needle)
+{
+  return Contains(begin, end, needle, strlen(needle));
+}
+
+/**
+ * @brief Bounds of the last space-separated token, as split(' ')[-1] after
+ *        dropping the line break.
+ */
+inline std::pair<const char*, const char*>
+LastToken(const char* begin, const char* end)
+{
+  while (end > begin && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' '))
+    --end;
+  const char* p = end;
+  while (p > begin && p[-1] != ' ' && p[-1] != '\t')
+    --p;
+  return std::make_pair(p, end);
+}
+
+/**
+ * @brief Parse a decimal number in [@p begin, @p end), e.g. "-1.5e+06".
+ */
+inline double
+ParseNumber(const char* begin, const char* end)
+{
+  bool negative = false;
+  if (begin < end && (*begin == '-' || *begin == '+'))
+    negative = *begin++ == '-';
+  double value = 0;
+  for (; begin < end && *begin >= '0' && *begin <= '9'; ++begin)
+    value = value * 10 + (*begin - '0');
+  if (begin < end && *begin == '.') {
+    double scale = 0.1;
+    for (++begin; begin < end && *begin >= '0' && *begin <= '9'; ++begin, scale /= 10)
+      value += (*begin - '0') * scale;
+  }
+  if (begin < end && (*begin == 'e' || *begin == 'E')) {
+    ++begin;
+    bool negative_exp = false;
+    if (begin < end && (*begin == '-' || *begin == '+'))
+      negative_exp = *begin++ == '-';
+    int exp = 0;
+    for (; begin < end && *begin >= '0' && *begin <= '9'; ++begin)
+      exp = exp * 10 + (*begin - '0');
+    for (; exp > 0; --exp)
+      value = negative_exp ? value / 10 : value * 10;
+  }
+  return negative ? -value : value;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Apply the rules of @p profile to every line in [@p begin, @p end).
+ */
+inline void
+ScanText(const char* begin, const char* end, Profile profile, TextStats& stats)
+{
+  const std::vector<Rule>& rules = Rules(profile);
+  std::vector<size_t> lens;
+  for (const auto& rule : rules)
+    lens.push_back(strlen(rule.needle));
+
+  while (begin < end) {
+    const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    const char* line_end = eol != nullptr ? eol : end;
+
+    if (detail::Contains(begin, line_end, "microseconds", 12)) {
+      bool is_data = detail::Contains(begin, line_end, "Store New Data", 14);
+      if (is_data || detail::Contains(begin, line_end, "Update New Seq", 14)) {
+        auto key = detail::LastToken(begin, line_end);
+        StoreLine store;
+        store.time = static_cast<int64_t>(detail::ParseNumber(begin, line_end));
+        store.key = key.first;
+        store.key_len = key.second - key.first;
+        store.is_state = !is_data;
+        stats.stores.push_back(store);
+      }
+    }
+
+    for (size_t i = 0; i < rules.size(); ++i) {
+      const Rule& rule = rules[i];
+      if (!detail::Contains(begin, line_end, rule.needle, lens[i]) ||
+          (rule.filter != nullptr && !detail::Contains(begin, line_end, rule.filter)))
+        continue;
+      if (rule.mode == Rule::kCount) {
+        stats.counters[rule.counter] += 1;
+        continue;
+      }
+      auto token = detail::LastToken(begin, line_end);
+      double value = detail::ParseNumber(token.first, token.second);
+      if (rule.mode == Rule::kLast) {
+        stats.counters[rule.counter] = value;
+        stats.has_last[rule.counter] = true;
+      }
+      else {
+        stats.counters[rule.counter] += value;
+      }
+    }
+    begin = line_end + 1;
+  }
+}
+
+/**
+ * @brief Split [@p begin, @p end) into at most @p n chunks of whole lines.
+ * @return n + 1 boundaries, or fewer for short texts
+ */
+inline std::vector<const char*>
+SplitLines(const char* begin, const char* end, size_t n)
+{
+  std::vector<const char*> bounds(1, begin);
+  size_t size = end - begin;
+  for (size_t i = 1; i < n; ++i) {
+    const char* p = begin + size * i / n;
+    if (p <= bounds.back())
+      continue;
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr)
+      break;
+    if (eol + 1 > bounds.back() && eol + 1 < end)
+      bounds.push_back(eol + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+/**
+ * @brief Availability of items (data or states) spreading over nodes.
+ *
+ * The first store of an item is its generation; the store that makes it
+ * reach the threshold number of owners makes it available, after the
+ * difference between the two.
+ */
+class Availability {
+ public:
+  explicit Availability(size_t threshold)
+    : threshold_(threshold)
+    , max_owners_(0)
+  {
+  }
+
+  template <typename Key, typename Hash>
+  struct Table {
+    std::unordered_map<Key, std::pair<int64_t, uint32_t>, Hash> items;  /* Birth, owners */
+  };
+
+  /**
+   * @brief Store of @p key at @p time, in @p table.
+   */
+  template <typename Key, typename Hash>
+  void
+  Store(Table<Key, Hash>& table, const Key& key, int64_t time)
+  {
+    auto it = table.items.find(key);
+    if (it == table.items.end()) {
+      table.items.emplace(key, std::make_pair(time, 1U));
+      produced_++;
+      if (threshold_ <= 1)
+        durations_.push_back(0);
+      max_owners_ = std::max<size_t>(max_owners_, 1);
+      return;
+    }
+    uint32_t owners = ++it->second.second;
+    max_owners_ = std::max<size_t>(max_owners_, owners);
+    if (owners == threshold_)
+      durations_.push_back((time - it->second.first) / 1000000.0);
+  }
+
+  /**
+   * @brief Take over the results of @p other, e.g. another shard.
+   */
+  void
+  Merge(const Availability& other)
+  {
+    produced_ += other.produced_;
+    max_owners_ = std::max(max_owners_, other.max_owners_);
+    durations_.insert(durations_.end(), other.durations_.begin(), other.durations_.end());
+  }
+
+  size_t Produced() const { return produced_; }
+  size_t MaxOwners() const { return max_owners_; }
+
+  /* Seconds from generation to availability, per available item */
+  std::vector<double>& Durations() { return durations_; }
+  const std::vector<double>& Durations() const { return durations_; }
+
+ private:
+  size_t threshold_;
+  size_t produced_ = 0;
+  size_t max_owners_;
+  std::vector<double> durations_;
+};
+
+struct EventKey {
+  uint64_t producer;
+  uint64_t seq;       /* Or the name id, with producer ~0 */
+
+  bool operator==(const EventKey& other) const {
+    return producer == other.producer && seq == other.seq;
+  }
+};
+
+struct EventKeyHash {
+  size_t operator()(const EventKey& key) const {
+    uint64_t h = key.producer * 0x9E3779B97F4A7C15ULL ^ key.seq;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 32);
+  }
+};
+
+inline EventKey
+KeyOf(const eventlog::EventRecord& record)
+{
+  if (record.name_id != 0)
+    return EventKey{~0ULL, record.name_id};
+  return EventKey{record.producer, record.seq};
+}
+
+struct EventStats {
+  EventStats(size_t data_threshold, size_t state_threshold)
+    : data(data_threshold)
+    , state(state_threshold)
+    , sends(kNumCounters, 0)
+  {
+  }
+
+  Availability data;
+  Availability state;
+  std::vector<double> sends;    /* kSend* counters */
+
+  void
+  Merge(const EventStats& other)
+  {
+    data.Merge(other.data);
+    state.Merge(other.state);
+    for (size_t i = 0; i < sends.size(); ++i)
+      sends[i] += other.sends[i];
+  }
+};
+
+/**
+ * @brief Process the records of shard @p shard out of @p shards.
+ *
+ * Records are sharded by item, so every shard sees all stores of its items
+ * in log order and shards can run in parallel over the same records.
+ */
+inline void
+ScanEvents(const eventlog::EventRecord* records, size_t count,
+           size_t shard, size_t shards, EventStats& stats)
+{
+  Availability::Table<EventKey, EventKeyHash> data_items, state_items;
+  EventKeyHash hash;
+  for (size_t i = 0; i < count; ++i) {
+    const eventlog::EventRecord& record = records[i];
+    EventKey key = KeyOf(record);
+    if (shards > 1 && hash(key) % shards != shard)
+      continue;
+    switch (record.type) {
+      case eventlog::kDataStore:
+        stats.data.Store(data_items, key, record.timestamp);
+        break;
+      case eventlog::kStateStore:
+        stats.state.Store(state_items, key, record.timestamp);
+        break;
+      case eventlog::kSendSyncInterest:
+        stats.sends[kSendSyncInterest]++;
+        break;
+      case eventlog::kSendSyncReply:
+        stats.sends[kSendSyncReply]++;
+        break;
+      case eventlog::kSendDataInterest:
+        stats.sends[kSendDataInterest]++;
+        break;
+      case eventlog::kSendDataReply:
+        stats.sends[kSendDataReply]++;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Feed the store lines of older text-only runs into @p stats.
+ */
+inline void
+ScanStoreLines(const std::vector<StoreLine>& stores, EventStats& stats)
+{
+  struct StringKeyHash {
+    size_t operator()(const std::string& key) const { return std::hash<std::string>()(key); }
+  };
+  Availability::Table<std::string, StringKeyHash> data_items, state_items;
+  for (const auto& store : stores) {
+    std::string key(store.key, store.key_len);
+    if (store.is_state)
+      stats.state.Store(state_items, key, store.time);
+    else
+      stats.data.Store(data_items, key, store.time);
+  }
+}
+
+inline double
+Mean(const std::vector<double>& values)
+{
+  if (values.empty())
+    return std::numeric_limits<double>::quiet_NaN();
+  double sum = 0;
+  for (double value : values)
+    sum += value;
+  return sum / values.size();
+}
+
+/**
+ * @brief @p q quantile of @p values, which get sorted.
+ */
+inline double
+Quantile(std::vector<double>& values, double q)
+{
+  if (values.empty())
+    return std::numeric_limits<double>::quiet_NaN();
+  std::sort(values.begin(), values.end());
+  size_t i = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+  return values[i];
+}
+
+}  // namespace analyzer
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_SYNC_ANALYZER_HPP_
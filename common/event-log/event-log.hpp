@@ -0,0 +1,433 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Binary event log shared by the DDSN, ChronoSync and PSync simulations.
+ *
+ * Every event is a fixed-size EventRecord appended to a per-run file, so
+ * logging is a copy into a ring drained by a writer thread instead of
+ * formatting and flushing a text line. Names that cannot be expressed as
+ * (producer, seq) are interned: the first use of a name appends it to the
+ * "<path>.names" sidecar file and records afterwards refer to it by id.
+ *
+ * Log file:    "SYNCEVT1" | uint32 version | uint32 record size | records...
+ * Names file:  "SYNCNAM1" | (uint32 id | uint32 length | bytes)...
+ *
+ * The log is header-only because the three simulations are built by separate
+ * waf projects; add "../common" to their include paths.
+ */
+
+#ifndef SYNC_COMMON_EVENT_LOG_HPP_
+#define SYNC_COMMON_EVENT_LOG_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include "spsc-ring.hpp"
+
+namespace ndn {
+namespace eventlog {
+
+enum EventType : uint16_t {
+  kNone = 0,
+  kDataStore = 1,          /* Node stored a new data */
+  kStateStore = 2,         /* Node learned a new (producer, seq) */
+  kPublish = 3,            /* Node produced a new data */
+  kSendSyncInterest = 4,
+  kSendSyncReply = 5,
+  kSendDataInterest = 6,
+  kSendDataReply = 7,
+  kDistance = 8,           /* Travelled distance, in millimeters in seq */
+};
+
+struct EventRecord {
+  int64_t timestamp;       /* Simulation time in microseconds */
+  uint64_t node;
+  uint64_t producer;
+  uint64_t seq;
+  uint32_t name_id;        /* 0 if the event has no interned name */
+  uint16_t type;
+  uint16_t reserved;
+};
+
+static_assert(sizeof(EventRecord) == 40, "EventRecord layout must not change");
+
+const char kLogMagic[8] = {'S', 'Y', 'N', 'C', 'E', 'V', 'T', '1'};
+const char kNamesMagic[8] = {'S', 'Y', 'N', 'C', 'N', 'A', 'M', '1'};
+const uint32_t kLogVersion = 1;
+
+/**
+ * @brief Process-wide writer.
+ *
+ * Opens lazily at the first event, at the path given to Open(), else
+ * $SYNC_EVENT_LOG, else "sync-events-<pid>.bin". Log() only copies the
+ * record into a lock-free ring; a background thread drains the ring to the
+ * file in batches, so the simulation thread does no file I/O per event.
+ * When the ring is full, Log() waits for the writer thread (kBlock) or
+ * drops the record (kDrop), which bounds memory either way. Records reach
+ * the file on Flush(), Close() or process exit. Events logged after Close(),
+ * e.g. from destructors at the end of a run, are counted and dropped until
+ * the next Open(), so the finished log is never overwritten.
+ *
+ * Log(), Intern(), Flush() and Close() must be called from one thread.
+ */
+class EventLogWriter {
+ public:
+  enum OverflowPolicy {
+    kBlock,
+    kDrop
+  };
+
+  struct Stats {
+    uint64_t logged;    /* Records queued for the writer thread */
+    uint64_t dropped;   /* Records dropped because the ring was full */
+    uint64_t stalls;    /* Log() calls that had to wait for the writer */
+    uint64_t late;      /* Records dropped because the log was closed */
+  };
+
+  static EventLogWriter&
+  Instance()
+  {
+    static EventLogWriter writer;
+    return writer;
+  }
+
+  /**
+   * @brief Write events to @p path from now on. Closes the current file.
+   */
+  void
+  Open(const std::string& path)
+  {
+    Shutdown();
+    path_ = path;
+    closed_ = false;
+    failed_ = false;
+  }
+
+  const std::string&
+  Path()
+  {
+    if (path_.empty()) {
+      const char* env = std::getenv("SYNC_EVENT_LOG");
+      path_ = env != nullptr ? env
+                             : "sync-events-" + std::to_string(getpid()) + ".bin";
+    }
+    return path_;
+  }
+
+  void
+  SetOverflowPolicy(OverflowPolicy policy)
+  {
+    policy_ = policy;
+  }
+
+  void
+  Log(int64_t timestamp, uint64_t node, EventType type,
+      uint64_t producer, uint64_t seq, uint32_t name_id = 0)
+  {
+    if (closed_) {
+      stats_.late++;
+      return;
+    }
+    if (log_ == nullptr && !OpenFiles())
+      return;
+    EventRecord record;
+    record.timestamp = timestamp;
+    record.node = node;
+    record.producer = producer;
+    record.seq = seq;
+    record.name_id = name_id;
+    record.type = type;
+    record.reserved = 0;
+    if (!ring_.TryPush(record)) {
+      if (policy_ == kDrop) {
+        stats_.dropped++;
+        return;
+      }
+      stats_.stalls++;
+      while (!ring_.TryPush(record))
+        std::this_thread::yield();
+    }
+    stats_.logged++;
+  }
+
+  /**
+   * @brief Id of @p name, defining it in the names file on first use.
+   *
+   * Names are few compared to records, so they are written directly.
+   */
+  uint32_t
+  Intern(const std::string& name)
+  {
+    auto it = name_ids_.find(name);
+    if (it != name_ids_.end())
+      return it->second;
+    if (closed_ || (names_ == nullptr && !OpenFiles()))
+      return 0;
+    uint32_t id = name_ids_.size() + 1;
+    name_ids_.emplace(name, id);
+    uint32_t len = name.size();
+    fwrite(&id, sizeof(id), 1, names_);
+    fwrite(&len, sizeof(len), 1, names_);
+    fwrite(name.data(), 1, len, names_);
+    return id;
+  }
+
+  /**
+   * @brief Wait until the writer thread has written everything logged so
+   *        far, and flush both files.
+   */
+  void
+  Flush()
+  {
+    if (log_ == nullptr)
+      return;
+    while (drained_.load(std::memory_order_acquire) < stats_.logged)
+      std::this_thread::yield();
+    fflush(log_);
+    fflush(names_);
+  }
+
+  /**
+   * @brief Write out and close the files. Nothing is logged until Open().
+   */
+  void
+  Close()
+  {
+    Shutdown();
+    closed_ = true;
+  }
+
+  const Stats&
+  GetStats() const
+  {
+    return stats_;
+  }
+
+  ~EventLogWriter()
+  {
+    Close();
+  }
+
+ private:
+  static const size_t kBufferSize = 1 << 20;
+  static const size_t kRingCapacity = 1 << 16;   /* Records, 2.5 MB */
+  static const int kDrainIntervalMs = 1;         /* Writer sleep when idle */
+
+  EventLogWriter()
+    : log_(nullptr)
+    , names_(nullptr)
+    , failed_(false)
+    , closed_(false)
+    , policy_(kBlock)
+    , stats_()
+    , ring_(kRingCapacity)
+    , stop_(false)
+    , drained_(0)
+  {
+  }
+
+  bool
+  OpenFiles()
+  {
+    if (failed_)
+      return false;
+    log_ = fopen(Path().c_str(), "wb");
+    names_ = fopen((path_ + ".names").c_str(), "wb");
+    if (log_ == nullptr || names_ == nullptr) {
+      fprintf(stderr, "Cannot open event log %s\n", path_.c_str());
+      Shutdown();
+      failed_ = true;
+      return false;
+    }
+    setvbuf(log_, nullptr, _IOFBF, kBufferSize);
+    uint32_t header[2] = {kLogVersion, sizeof(EventRecord)};
+    fwrite(kLogMagic, 1, sizeof(kLogMagic), log_);
+    fwrite(header, sizeof(header), 1, log_);
+    fwrite(kNamesMagic, 1, sizeof(kNamesMagic), names_);
+
+    stats_ = Stats();
+    drained_.store(0, std::memory_order_relaxed);
+    stop_.store(false, std::memory_order_relaxed);
+    writer_ = std::thread(&EventLogWriter::Drain, this);
+    return true;
+  }
+
+  void
+  Shutdown()
+  {
+    if (writer_.joinable()) {
+      stop_.store(true, std::memory_order_release);
+      writer_.join();
+    }
+    if (log_ != nullptr)
+      fclose(log_);
+    if (names_ != nullptr)
+      fclose(names_);
+    log_ = names_ = nullptr;
+    name_ids_.clear();
+  }
+
+  /* Writer thread */
+  void
+  Drain()
+  {
+    FILE* log = log_;
+    auto write = [log] (const EventRecord* records, size_t count) {
+      fwrite(records, sizeof(EventRecord), count, log);
+    };
+    while (true) {
+      /* Read the flag first, so that everything logged before Close() is drained */
+      bool stop = stop_.load(std::memory_order_acquire);
+      size_t count = ring_.Drain(write);
+      drained_.fetch_add(count, std::memory_order_release);
+      if (count == 0) {
+        if (stop)
+          return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(int(kDrainIntervalMs)));
+      }
+    }
+  }
+
+  std::string path_;
+  FILE* log_;
+  FILE* names_;
+  bool failed_;
+  bool closed_;                  /* Close() was called, Open() was not since */
+  std::unordered_map<std::string, uint32_t> name_ids_;
+  OverflowPolicy policy_;
+  Stats stats_;
+
+  SpscRing<EventRecord> ring_;
+  std::thread writer_;
+  std::atomic<bool> stop_;
+  std::atomic<uint64_t> drained_;
+};
+
+inline void
+LogEvent(int64_t timestamp, uint64_t node, EventType type,
+         uint64_t producer, uint64_t seq)
+{
+  EventLogWriter::Instance().Log(timestamp, node, type, producer, seq);
+}
+
+/**
+ * @brief Write out and close the log, e.g. from Simulator::ScheduleDestroy().
+ */
+inline void
+CloseEventLog()
+{
+  EventLogWriter::Instance().Close();
+}
+
+/**
+ * @brief Log an event about @p name, e.g. a ChronoSync data name.
+ *
+ * Only for names that recur, such as data names. Sync interest and reply
+ * names carry a digest that changes with every state, so each would be
+ * interned anew; log those events with LogEvent(..., 0, 0).
+ */
+inline void
+LogEvent(int64_t timestamp, uint64_t node, EventType type,
+         const std::string& name)
+{
+  auto& writer = EventLogWriter::Instance();
+  writer.Log(timestamp, node, type, 0, 0, writer.Intern(name));
+}
+
+/**
+ * @brief Sequential reader of a log written by EventLogWriter.
+ */
+class EventLogReader {
+ public:
+  EventLogReader()
+    : log_(nullptr)
+  {
+  }
+
+  ~EventLogReader()
+  {
+    if (log_ != nullptr)
+      fclose(log_);
+  }
+
+  EventLogReader(const EventLogReader&) = delete;
+  EventLogReader& operator=(const EventLogReader&) = delete;
+
+  /**
+   * @brief Open the log at @p path and load its names.
+   * @return false if the file is missing or not an event log
+   */
+  bool
+  Open(const std::string& path)
+  {
+    log_ = fopen(path.c_str(), "rb");
+    if (log_ == nullptr)
+      return false;
+    char magic[8];
+    uint32_t header[2];
+    if (fread(magic, 1, sizeof(magic), log_) != sizeof(magic) ||
+        memcmp(magic, kLogMagic, sizeof(magic)) != 0 ||
+        fread(header, sizeof(header), 1, log_) != 1 ||
+        header[0] != kLogVersion || header[1] != sizeof(EventRecord))
+      return false;
+    return LoadNames(path + ".names");
+  }
+
+  /**
+   * @return false at the end of the log
+   */
+  bool
+  Next(EventRecord& record)
+  {
+    return log_ != nullptr && fread(&record, sizeof(record), 1, log_) == 1;
+  }
+
+  /**
+   * @brief Interned name of @p id, or an empty string.
+   */
+  const std::string&
+  Name(uint32_t id) const
+  {
+    static const std::string kEmpty;
+    return id < names_.size() ? names_[id] : kEmpty;
+  }
+
+ private:
+  bool
+  LoadNames(const std::string& path)
+  {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr)
+      return false;
+    char magic[8];
+    bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+              memcmp(magic, kNamesMagic, sizeof(magic)) == 0;
+    uint32_t entry[2];
+    while (ok && fread(entry, sizeof(entry), 1, f) == 1) {
+      std::string name(entry[1], '\0');
+      if (entry[1] > 0 && fread(&name[0], 1, entry[1], f) != entry[1])
+        break;
+      if (names_.size() <= entry[0])
+        names_.resize(entry[0] + 1);
+      names_[entry[0]] = std::move(name);
+    }
+    fclose(f);
+    return ok;
+  }
+
+  FILE* log_;
+  std::vector<std::string> names_;   /* [id] */
+};
+
+}  // namespace eventlog
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_EVENT_LOG_HPP_
@@ -0,0 +1,59 @@
+# -*- coding: utf-8 -*-
+"""
+    Reader of the binary event log written by event-log.hpp.
+"""
+
+import struct
+
+LOG_MAGIC = b"SYNCEVT1"
+NAMES_MAGIC = b"SYNCNAM1"
+LOG_VERSION = 1
+
+DATA_STORE = 1
+STATE_STORE = 2
+PUBLISH = 3
+SEND_SYNC_INTEREST = 4
+SEND_SYNC_REPLY = 5
+SEND_DATA_INTEREST = 6
+SEND_DATA_REPLY = 7
+DISTANCE = 8
+
+_RECORD = struct.Struct("<qQQQIHH")
+_CHUNK = 4096
+
+
+def _read_names(path):
+    names = {}
+    with open(path, "rb") as f:
+        if f.read(len(NAMES_MAGIC)) != NAMES_MAGIC:
+            raise ValueError("not an event log names file: " + path)
+        while True:
+            entry = f.read(8)
+            if len(entry) < 8:
+                break
+            name_id, length = struct.unpack("<II", entry)
+            names[name_id] = f.read(length).decode("utf-8")
+    return names
+
+
+def read_events(path):
+    """
+    Yield (timestamp, node, type, key) for every event in the log at path.
+    key is the interned name if the event has one, else (producer, seq).
+    """
+    names = _read_names(path + ".names")
+    with open(path, "rb") as f:
+        if f.read(len(LOG_MAGIC)) != LOG_MAGIC:
+            raise ValueError("not an event log: " + path)
+        version, size = struct.unpack("<II", f.read(8))
+        if version != LOG_VERSION or size != _RECORD.size:
+            raise ValueError("unsupported event log version: " + path)
+        while True:
+            chunk = f.read(_RECORD.size * _CHUNK)
+            if not chunk:
+                break
+            for offset in range(0, len(chunk) - _RECORD.size + 1, _RECORD.size):
+                ts, node, producer, seq, name_id, event_type, _ = \
+                    _RECORD.unpack_from(chunk, offset)
+                key = names[name_id] if name_id != 0 else (producer, seq)
+                yield ts, node, event_type, key
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Lock-free ring buffer with a single producer and a single consumer.
+ */
+
+#ifndef SYNC_COMMON_SPSC_RING_HPP_
+#define SYNC_COMMON_SPSC_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ndn {
+namespace eventlog {
+
+/**
+ * @brief Fixed-capacity FIFO of trivially copyable @p T.
+ *
+ * TryPush() may only be called from one thread and Drain() from one other
+ * thread. Neither blocks: the producer sees a full ring as a failed push and
+ * decides itself whether to wait or drop.
+ */
+template <typename T>
+class SpscRing {
+ public:
+  /**
+   * @param capacity rounded up to a power of two
+   */
+  explicit SpscRing(size_t capacity)
+    : head_(0)
+    , tail_(0)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    buffer_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  /**
+   * @return false if the ring is full
+   */
+  bool
+  TryPush(const T& item)
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == buffer_.size())
+      return false;
+    buffer_[head & mask_] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Hand all queued items to @p write as at most two contiguous spans,
+   *        then release their slots.
+   * @param write called as write(const T* items, size_t count)
+   * @return number of items drained
+   */
+  template <typename Write>
+  size_t
+  Drain(Write write)
+  {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t count = head_.load(std::memory_order_acquire) - tail;
+    if (count == 0)
+      return 0;
+    size_t first = tail & mask_;
+    size_t span = std::min(count, buffer_.size() - first);
+    write(&buffer_[first], span);
+    if (span < count)
+      write(&buffer_[0], count - span);
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  bool
+  Empty() const
+  {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  size_t
+  Capacity() const
+  {
+    return buffer_.size();
+  }
+
+ private:
+  std::vector<T> buffer_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> head_;   /* Next slot to write, producer side */
+  alignas(64) std::atomic<size_t> tail_;   /* Next slot to read, consumer side */
+};
+
+}  // namespace eventlog
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_SPSC_RING_HPP_
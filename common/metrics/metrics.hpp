@@ -0,0 +1,482 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Metrics registry with periodic time-series sampling.
+ *
+ * Each node (or forwarder) owns a MetricsRegistry of counters, gauges and
+ * histograms. Sample() appends the current value of every counter and gauge
+ * as one row of the registry's time series. At the end of a run
+ * MetricsExporter writes the series of all registries, with final counter
+ * values and histograms, to "<prefix>.json" and "<prefix>.csv". Histograms
+ * of the same name are also merged over all registries, e.g. into the
+ * latency distribution of the whole network.
+ *
+ * Header-only, like the event log, so any of the simulations can use it.
+ */
+
+#ifndef SYNC_COMMON_METRICS_HPP_
+#define SYNC_COMMON_METRICS_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ndn {
+namespace metrics {
+
+/**
+ * @brief Monotonic event count. Behaves like the integer it replaces.
+ */
+class Counter {
+ public:
+  Counter() : value_(0) {}
+
+  Counter& operator++() { ++value_; return *this; }
+  uint64_t operator++(int) { return value_++; }
+  Counter& operator+=(uint64_t n) { value_ += n; return *this; }
+
+  uint64_t Value() const { return value_; }
+  operator uint64_t() const { return value_; }
+  void Set(uint64_t value) { value_ = value; }
+
+ private:
+  uint64_t value_;
+};
+
+/**
+ * @brief Distribution over fixed buckets.
+ *
+ * Bucket i counts values in (bounds[i-1], bounds[i]]; one more bucket counts
+ * values above the last bound.
+ */
+class Histogram {
+ public:
+  explicit Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds))
+    , counts_(bounds_.size() + 1, 0)
+    , count_(0)
+    , sum_(0)
+    , min_(std::numeric_limits<double>::infinity())
+    , max_(-std::numeric_limits<double>::infinity())
+  {
+  }
+
+  /**
+   * @brief @p n bounds growing geometrically from @p first by @p factor.
+   */
+  static std::vector<double>
+  ExponentialBounds(double first, double factor, size_t n)
+  {
+    std::vector<double> bounds;
+    for (double b = first; bounds.size() < n; b *= factor)
+      bounds.push_back(b);
+    return bounds;
+  }
+
+  void
+  Record(double value)
+  {
+    size_t i = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    counts_[i]++;
+    count_++;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  /**
+   * @brief Add the values recorded in @p other, which has the same bounds.
+   * @return false, leaving this histogram unchanged, if the bounds differ
+   */
+  bool
+  Merge(const Histogram& other)
+  {
+    if (other.bounds_ != bounds_)
+      return false;
+    for (size_t i = 0; i < counts_.size(); ++i)
+      counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    return true;
+  }
+
+  /**
+   * @brief Estimate the @p q quantile (0 <= q <= 1), interpolating linearly
+   *        within the bucket it falls in.
+   * @return NaN if nothing was recorded
+   */
+  double
+  Quantile(double q) const
+  {
+    if (count_ == 0)
+      return std::numeric_limits<double>::quiet_NaN();
+    double rank = q * count_;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      if (counts_[i] == 0 || seen + counts_[i] < rank) {
+        seen += counts_[i];
+        continue;
+      }
+      double lo = i == 0 ? min_ : std::max(bounds_[i - 1], min_);
+      double hi = i == bounds_.size() ? max_ : std::min(bounds_[i], max_);
+      return lo + (hi - lo) * (rank - seen) / counts_[i];
+    }
+    return max_;
+  }
+
+  const std::vector<double>& Bounds() const { return bounds_; }
+  const std::vector<uint64_t>& Counts() const { return counts_; }
+  uint64_t Count() const { return count_; }
+  double Sum() const { return sum_; }
+  double Min() const { return min_; }
+  double Max() const { return max_; }
+
+ private:
+  std::vector<double> bounds_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_;
+  double sum_;
+  double min_;
+  double max_;
+};
+
+/**
+ * @brief What the exporter keeps of a registry, so it outlives the registry.
+ */
+struct Series {
+  uint64_t source;
+  std::vector<std::string> columns;
+  std::vector<int64_t> times;                 /* Microseconds */
+  std::vector<std::vector<double>> rows;      /* A row has a value per column known then */
+  std::vector<std::pair<std::string, uint64_t>> totals;
+  std::vector<std::pair<std::string, Histogram>> histograms;
+};
+
+class MetricsRegistry;
+
+/**
+ * @brief Process-wide collection of registries and their export.
+ */
+class MetricsExporter {
+ public:
+  static MetricsExporter&
+  Instance()
+  {
+    static MetricsExporter exporter;
+    return exporter;
+  }
+
+  /**
+   * @brief Enable sampling every @p interval_ms and export to
+   *        "@p prefix.json" and "@p prefix.csv" on Close().
+   */
+  void
+  Open(const std::string& prefix, int64_t interval_ms)
+  {
+    prefix_ = prefix;
+    interval_ms_ = interval_ms;
+  }
+
+  bool
+  Enabled() const
+  {
+    return !prefix_.empty() && interval_ms_ > 0;
+  }
+
+  int64_t
+  IntervalMs() const
+  {
+    return interval_ms_;
+  }
+
+  /**
+   * @brief Write out every registry, live or gone, then forget them.
+   */
+  inline void
+  Close();
+
+ private:
+  friend class MetricsRegistry;
+
+  MetricsExporter()
+    : interval_ms_(0)
+  {
+  }
+
+  std::shared_ptr<Series>
+  Register(MetricsRegistry* registry, uint64_t source)
+  {
+    auto series = std::make_shared<Series>();
+    series->source = source;
+    series_.push_back(series);
+    live_.insert(registry);
+    return series;
+  }
+
+  void
+  Unregister(MetricsRegistry* registry)
+  {
+    live_.erase(registry);
+  }
+
+  void
+  WriteJson(std::ostream& os) const;
+
+  void
+  WriteCsv(std::ostream& os) const;
+
+  /**
+   * @brief Histograms of the same name merged over all sources.
+   */
+  std::map<std::string, Histogram>
+  MergeHistograms() const;
+
+  std::string prefix_;
+  int64_t interval_ms_;
+  std::vector<std::shared_ptr<Series>> series_;
+  std::set<MetricsRegistry*> live_;
+};
+
+class MetricsRegistry {
+ public:
+  using Reader = std::function<double()>;
+
+  /**
+   * @param source node id the metrics belong to
+   */
+  explicit MetricsRegistry(uint64_t source)
+    : series_(MetricsExporter::Instance().Register(this, source))
+  {
+  }
+
+  ~MetricsRegistry()
+  {
+    Finish();
+    MetricsExporter::Instance().Unregister(this);
+  }
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  /**
+   * @brief Counter called @p name, created at first use.
+   */
+  Counter&
+  GetCounter(const std::string& name)
+  {
+    auto it = counters_.find(name);
+    if (it != counters_.end())
+      return it->second;
+    Counter& counter = counters_[name];
+    AddGauge(name, [&counter] { return static_cast<double>(counter.Value()); });
+    return counter;
+  }
+
+  const std::map<std::string, Counter>&
+  Counters() const
+  {
+    return counters_;
+  }
+
+  /**
+   * @brief Sample @p read under @p name, e.g. a queue depth.
+   */
+  void
+  AddGauge(const std::string& name, Reader read)
+  {
+    series_->columns.push_back(name);
+    readers_.push_back(std::move(read));
+  }
+
+  /**
+   * @brief Histogram called @p name, created with @p bounds at first use.
+   */
+  Histogram&
+  GetHistogram(const std::string& name, const std::vector<double>& bounds)
+  {
+    auto it = histograms_.find(name);
+    if (it == histograms_.end())
+      it = histograms_.emplace(name, Histogram(bounds)).first;
+    return it->second;
+  }
+
+  /**
+   * @brief Append the current counter and gauge values at @p time (us).
+   */
+  void
+  Sample(int64_t time)
+  {
+    std::vector<double> row;
+    row.reserve(readers_.size());
+    for (const auto& read : readers_)
+      row.push_back(read());
+    series_->times.push_back(time);
+    series_->rows.push_back(std::move(row));
+  }
+
+  /**
+   * @brief Copy final counter values and histograms into the series.
+   */
+  void
+  Finish()
+  {
+    series_->totals.clear();
+    for (const auto& entry : counters_)
+      series_->totals.emplace_back(entry.first, entry.second.Value());
+    series_->histograms.clear();
+    for (const auto& entry : histograms_)
+      series_->histograms.emplace_back(entry.first, entry.second);
+  }
+
+ private:
+  std::shared_ptr<Series> series_;
+  std::vector<Reader> readers_;               /* Same order as series_->columns */
+  std::map<std::string, Counter> counters_;
+  std::map<std::string, Histogram> histograms_;
+};
+
+namespace detail {
+
+inline void
+WriteNumber(std::ostream& os, double value)
+{
+  if (std::isfinite(value))
+    os << value;
+  else
+    os << "null";
+}
+
+inline void
+WriteHistogram(std::ostream& os, const std::string& name, const Histogram& histogram)
+{
+  os << '"' << name << "\": {\"bounds\": [";
+  for (size_t i = 0; i < histogram.Bounds().size(); ++i)
+    os << (i ? ", " : "") << histogram.Bounds()[i];
+  os << "], \"counts\": [";
+  for (size_t i = 0; i < histogram.Counts().size(); ++i)
+    os << (i ? ", " : "") << histogram.Counts()[i];
+  os << "], \"count\": " << histogram.Count() << ", \"sum\": " << histogram.Sum();
+  os << ", \"p50\": ";
+  WriteNumber(os, histogram.Quantile(0.5));
+  os << ", \"p90\": ";
+  WriteNumber(os, histogram.Quantile(0.9));
+  os << ", \"p99\": ";
+  WriteNumber(os, histogram.Quantile(0.99));
+  os << '}';
+}
+
+}  // namespace detail
+
+inline std::map<std::string, Histogram>
+MetricsExporter::MergeHistograms() const
+{
+  std::map<std::string, Histogram> merged;
+  for (const auto& series : series_) {
+    for (const auto& entry : series->histograms) {
+      auto it = merged.find(entry.first);
+      if (it == merged.end())
+        merged.emplace(entry.first, entry.second);
+      else
+        it->second.Merge(entry.second);
+    }
+  }
+  return merged;
+}
+
+inline void
+MetricsExporter::WriteJson(std::ostream& os) const
+{
+  os << "{\"interval_ms\": " << interval_ms_ << ", \"sources\": [";
+  for (size_t s = 0; s < series_.size(); ++s) {
+    const Series& series = *series_[s];
+    os << (s ? ",\n" : "\n") << "{\"source\": " << series.source << ", \"columns\": [";
+    for (size_t i = 0; i < series.columns.size(); ++i)
+      os << (i ? ", " : "") << '"' << series.columns[i] << '"';
+    os << "],\n \"samples\": [";
+    for (size_t r = 0; r < series.rows.size(); ++r) {
+      os << (r ? ", " : "") << '[' << series.times[r];
+      for (size_t i = 0; i < series.columns.size(); ++i) {
+        os << ", ";
+        if (i < series.rows[r].size())
+          detail::WriteNumber(os, series.rows[r][i]);
+        else
+          os << "null";
+      }
+      os << ']';
+    }
+    os << "],\n \"totals\": {";
+    for (size_t i = 0; i < series.totals.size(); ++i)
+      os << (i ? ", " : "") << '"' << series.totals[i].first << "\": " << series.totals[i].second;
+    os << "},\n \"histograms\": {";
+    for (size_t h = 0; h < series.histograms.size(); ++h) {
+      os << (h ? ", " : "");
+      detail::WriteHistogram(os, series.histograms[h].first, series.histograms[h].second);
+    }
+    os << "}}";
+  }
+  os << "\n],\n\"merged\": {";
+  bool first = true;
+  for (const auto& entry : MergeHistograms()) {
+    os << (first ? "\n" : ",\n");
+    detail::WriteHistogram(os, entry.first, entry.second);
+    first = false;
+  }
+  os << "\n}}\n";
+}
+
+inline void
+MetricsExporter::WriteCsv(std::ostream& os) const
+{
+  /* Long format, so sources with different columns share one table */
+  os << "source,time_us,metric,value\n";
+  for (const auto& series : series_) {
+    for (size_t r = 0; r < series->rows.size(); ++r) {
+      for (size_t i = 0; i < series->rows[r].size(); ++i) {
+        os << series->source << ',' << series->times[r] << ','
+           << series->columns[i] << ',' << series->rows[r][i] << '\n';
+      }
+    }
+  }
+}
+
+inline void
+MetricsExporter::Close()
+{
+  if (!prefix_.empty()) {
+    for (auto registry : live_)
+      registry->Finish();
+    std::ofstream json(prefix_ + ".json");
+    json.precision(15);
+    WriteJson(json);
+    std::ofstream csv(prefix_ + ".csv");
+    csv.precision(15);
+    WriteCsv(csv);
+  }
+  series_.clear();
+  prefix_.clear();
+}
+
+/**
+ * @brief Export the metrics, e.g. from Simulator::ScheduleDestroy().
+ */
+inline void
+CloseMetrics()
+{
+  MetricsExporter::Instance().Close();
+}
+
+}  // namespace metrics
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_METRICS_HPP_
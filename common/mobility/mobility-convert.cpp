@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Compile ns-2 movement traces into binary waypoint tables, see
+ * waypoint-table.hpp:
+ *
+ *   mobility-convert <trace.ns_movements>...
+ *
+ * The table of each trace is written next to it with the extension .wpt,
+ * where the scenarios look for it.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "mobility/waypoint-table.hpp"
+
+using namespace ndn::mobility;
+
+int
+main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <trace.ns_movements>...\n", argv[0]);
+    return 1;
+  }
+  int failed = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string trace = argv[i];
+    std::string table = trace.substr(0, trace.rfind('.')) + ".wpt";
+    uint64_t size, hash;
+    std::ifstream in(trace.c_str());
+    WaypointTable waypoints;
+    std::string error;
+    if (!in || !HashFile(trace, size, hash)) {
+      fprintf(stderr, "Cannot read %s\n", trace.c_str());
+      ++failed;
+    }
+    else if (!ParseNs2(in, waypoints, error)) {
+      fprintf(stderr, "%s: %s\n", trace.c_str(), error.c_str());
+      ++failed;
+    }
+    else if (!WriteTable(table, waypoints, size, hash)) {
+      fprintf(stderr, "Cannot write %s\n", table.c_str());
+      ++failed;
+    }
+    else {
+      size_t count = 0;
+      for (const auto& path : waypoints)
+        count += path.size();
+      printf("%s: %zu nodes, %zu waypoints -> %s\n", trace.c_str(), waypoints.size(), count,
+             table.c_str());
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
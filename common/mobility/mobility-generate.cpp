@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Generate synthetic mobility for large scenarios, see
+ * mobility-generator.hpp:
+ *
+ *   mobility-generate [options] <output>
+ *
+ * writes <output>.ns_movements, <output>.wpt or both (the default), e.g.
+ * `mobility-generate --nodes=2000 trace/scenario-2000` for the DDSN
+ * scenario with --mobileNodeNum=2000. The table written along with the
+ * trace is read back from it, as mobility-convert would, so
+ * InstallMobilityTrace() takes the table.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "mobility/mobility-generator.hpp"
+#include "mobility/waypoint-table.hpp"
+
+using namespace ndn::mobility;
+
+namespace {
+
+void
+Usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--model=waypoint|manhattan|group] [--nodes=N] [--time=S]\n"
+          "       [--area=WxH] [--speed=MIN-MAX] [--pause=S] [--random-pause]\n"
+          "       [--block=M] [--group-size=N] [--group-radius=M] [--seed=N]\n"
+          "       [--threads=N] [--format=ns2|wpt|both] <output>\n",
+          program);
+}
+
+bool
+Option(const std::string& arg, const char* name, std::string& value) {
+  std::string prefix = std::string("--") + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0)
+    return false;
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+size_t
+Count(const WaypointTable& table) {
+  size_t count = 0;
+  for (const auto& path : table)
+    count += path.size();
+  return count;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  GeneratorConfig config;
+  size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  std::string format = "both";
+  std::string output;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i], value;
+    bool ok = true;
+    if (Option(arg, "model", value)) {
+      if (value == "waypoint")
+        config.model = GeneratorConfig::kWaypoint;
+      else if (value == "manhattan")
+        config.model = GeneratorConfig::kManhattan;
+      else if (value == "group")
+        config.model = GeneratorConfig::kGroup;
+      else
+        ok = false;
+    }
+    else if (Option(arg, "nodes", value))
+      config.nodes = std::strtoul(value.c_str(), nullptr, 10);
+    else if (Option(arg, "time", value))
+      config.duration = std::atof(value.c_str());
+    else if (Option(arg, "area", value))
+      ok = sscanf(value.c_str(), "%lfx%lf", &config.width, &config.height) == 2;
+    else if (Option(arg, "speed", value))
+      ok = sscanf(value.c_str(), "%lf-%lf", &config.min_speed, &config.max_speed) == 2;
+    else if (Option(arg, "pause", value))
+      config.pause = std::atof(value.c_str());
+    else if (arg == "--random-pause")
+      config.random_pause = true;
+    else if (Option(arg, "block", value))
+      config.block = std::atof(value.c_str());
+    else if (Option(arg, "group-size", value))
+      config.group_size = std::strtoul(value.c_str(), nullptr, 10);
+    else if (Option(arg, "group-radius", value))
+      config.group_radius = std::atof(value.c_str());
+    else if (Option(arg, "seed", value))
+      config.seed = std::strtoull(value.c_str(), nullptr, 10);
+    else if (Option(arg, "threads", value))
+      threads = std::max(1UL, std::strtoul(value.c_str(), nullptr, 10));
+    else if (Option(arg, "format", value))
+      ok = (format = value) == "ns2" || format == "wpt" || format == "both";
+    else if (arg.compare(0, 2, "--") != 0 && output.empty())
+      output = arg;
+    else
+      ok = false;
+    if (!ok) {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (output.empty() || config.width <= 0 || config.height <= 0 || config.block <= 0 ||
+      config.min_speed <= 0 || config.max_speed < config.min_speed) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  WaypointTable table = Generate(config, threads);
+
+  uint64_t size = 0, hash = 0;
+  if (format != "wpt") {
+    std::string trace = output + ".ns_movements";
+    {
+      std::ofstream out(trace.c_str());
+      for (uint32_t node = 0; node < table.size(); ++node)
+        out << FormatNs2(node, table[node]);
+      if (!out) {
+        fprintf(stderr, "Cannot write %s\n", trace.c_str());
+        return 1;
+      }
+    }
+    /* The table of the trace itself, as mobility-convert would write it */
+    std::ifstream in(trace.c_str());
+    std::string error;
+    if (!HashFile(trace, size, hash) || !ParseNs2(in, table, error)) {
+      fprintf(stderr, "Cannot read back %s\n", trace.c_str());
+      return 1;
+    }
+    printf("%u nodes, %zu waypoints -> %s\n", config.nodes, Count(table), trace.c_str());
+  }
+  if (format != "ns2") {
+    std::string path = output + ".wpt";
+    if (!WriteTable(path, table, size, hash)) {
+      fprintf(stderr, "Cannot write %s\n", path.c_str());
+      return 1;
+    }
+    printf("%u nodes, %zu waypoints -> %s\n", config.nodes, Count(table), path.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Synthetic mobility for scenarios far larger than the shipped traces.
+ *
+ * Models, all within [0, width] x [0, height]:
+ *
+ *   waypoint   Random waypoint: head for a uniform random point at a uniform
+ *              random speed, pause, repeat. The model of installMobility()
+ *              in the DDSN scenario.
+ *   manhattan  Move along a grid of streets every `block` meters, going
+ *              straight at an intersection with probability 1/2 and turning
+ *              left or right with 1/4 each, at a new speed per block.
+ *   group      Reference point group mobility: groups of `group_size` nodes
+ *              follow a random waypoint reference point, each node within
+ *              `group_radius` of it.
+ *
+ * Every node draws from its own generator seeded from the seed and its id,
+ * so a node's path does not depend on the number of nodes, threads or the
+ * order of generation. Paths are waypoint tables, see waypoint-table.hpp,
+ * and can be written as ns-2 movements. mobility-generate.cpp is the tool.
+ */
+
+#ifndef SYNC_COMMON_MOBILITY_GENERATOR_HPP_
+#define SYNC_COMMON_MOBILITY_GENERATOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mobility/waypoint-table.hpp"
+
+namespace ndn {
+namespace mobility {
+
+struct GeneratorConfig {
+  enum Model { kWaypoint, kManhattan, kGroup };
+
+  Model model = kWaypoint;
+  uint32_t nodes = 20;
+  double duration = 2400;           /* Seconds of movement to generate */
+  double width = 800;
+  double height = 800;
+  double min_speed = 1;             /* m/s */
+  double max_speed = 20;
+  double pause = 0;                 /* Seconds at each waypoint */
+  bool random_pause = false;        /* Exponential pauses of mean `pause` */
+  double block = 100;               /* manhattan: street spacing */
+  uint32_t group_size = 5;          /* group */
+  double group_radius = 50;
+  uint64_t seed = 1;
+};
+
+namespace detail {
+
+/* Uniform in [a, b), the same on every standard library */
+inline double
+Uniform(std::mt19937_64& rng, double a, double b)
+{
+  return a + (b - a) * ((rng() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+inline std::mt19937_64
+Engine(uint64_t seed, uint64_t stream)
+{
+  std::seed_seq seq = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                       static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+  return std::mt19937_64(seq);
+}
+
+inline double
+Pause(const GeneratorConfig& config, std::mt19937_64& rng)
+{
+  if (!config.random_pause || config.pause <= 0)
+    return config.pause;
+  return -config.pause * std::log(1 - Uniform(rng, 0, 1));
+}
+
+inline std::vector<Waypoint>
+RandomWaypoint(const GeneratorConfig& config, std::mt19937_64& rng)
+{
+  std::vector<Waypoint> path;
+  Waypoint w = {0, Uniform(rng, 0, config.width), Uniform(rng, 0, config.height), 0};
+  path.push_back(w);
+  while (w.t < config.duration) {
+    double x = Uniform(rng, 0, config.width);
+    double y = Uniform(rng, 0, config.height);
+    double speed = Uniform(rng, config.min_speed, config.max_speed);
+    double distance = std::hypot(x - w.x, y - w.y);
+    w = {w.t + std::max(distance / speed, 1e-3), x, y, 0};
+    path.push_back(w);
+    double pause = Pause(config, rng);
+    if (pause > 0) {
+      w.t += pause;
+      path.push_back(w);
+    }
+  }
+  return path;
+}
+
+inline std::vector<Waypoint>
+Manhattan(const GeneratorConfig& config, std::mt19937_64& rng)
+{
+  /* Intersections (i * block, j * block), streets between them */
+  int columns = std::max(1, static_cast<int>(config.width / config.block));
+  int rows = std::max(1, static_cast<int>(config.height / config.block));
+  static const int kDx[] = {1, 0, -1, 0};
+  static const int kDy[] = {0, 1, 0, -1};
+  int i = static_cast<int>(Uniform(rng, 0, columns + 1));
+  int j = static_cast<int>(Uniform(rng, 0, rows + 1));
+  int heading = static_cast<int>(Uniform(rng, 0, 4));
+
+  std::vector<Waypoint> path;
+  Waypoint w = {0, i * config.block, j * config.block, 0};
+  path.push_back(w);
+  while (w.t < config.duration) {
+    double turn = Uniform(rng, 0, 1);
+    if (turn >= 0.5)
+      heading = (heading + (turn < 0.75 ? 1 : 3)) % 4;
+    /* Turn back at the edge of the grid */
+    for (int tries = 0; tries < 4; ++tries) {
+      int ni = i + kDx[heading], nj = j + kDy[heading];
+      if (ni >= 0 && ni <= columns && nj >= 0 && nj <= rows)
+        break;
+      heading = (heading + (tries == 1 ? 1 : 2)) % 4;
+    }
+    i += kDx[heading];
+    j += kDy[heading];
+    double speed = Uniform(rng, config.min_speed, config.max_speed);
+    w = {w.t + config.block / speed, i * config.block, j * config.block, 0};
+    path.push_back(w);
+    double pause = Pause(config, rng);
+    if (pause > 0) {
+      w.t += pause;
+      path.push_back(w);
+    }
+  }
+  return path;
+}
+
+inline std::vector<Waypoint>
+Group(const GeneratorConfig& config, uint32_t node)
+{
+  /* The reference point has a stream of its own, past those of the nodes */
+  uint32_t group = node / std::max<uint32_t>(1, config.group_size);
+  std::mt19937_64 reference_rng = Engine(config.seed, (1ULL << 32) + group);
+  std::vector<Waypoint> reference = RandomWaypoint(config, reference_rng);
+
+  std::mt19937_64 rng = Engine(config.seed, node);
+  std::vector<Waypoint> path;
+  for (const auto& point : reference) {
+    double angle = Uniform(rng, 0, 2 * M_PI);
+    double radius = config.group_radius * std::sqrt(Uniform(rng, 0, 1));
+    double x = std::min(config.width, std::max(0.0, point.x + radius * std::cos(angle)));
+    double y = std::min(config.height, std::max(0.0, point.y + radius * std::sin(angle)));
+    path.push_back({point.t, x, y, 0});
+  }
+  return path;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Path of @p node, the same whatever else is generated.
+ */
+inline std::vector<Waypoint>
+GeneratePath(const GeneratorConfig& config, uint32_t node)
+{
+  std::mt19937_64 rng = detail::Engine(config.seed, node);
+  switch (config.model) {
+    case GeneratorConfig::kManhattan:
+      return detail::Manhattan(config, rng);
+    case GeneratorConfig::kGroup:
+      return detail::Group(config, node);
+    default:
+      return detail::RandomWaypoint(config, rng);
+  }
+}
+
+/**
+ * @brief Paths of all nodes, generated on @p threads threads.
+ */
+inline WaypointTable
+Generate(const GeneratorConfig& config, size_t threads)
+{
+  WaypointTable table(config.nodes);
+  std::atomic<uint32_t> next(0);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < std::max<size_t>(1, threads); ++t) {
+    workers.emplace_back([&config, &table, &next] {
+      for (uint32_t node = next++; node < config.nodes; node = next++)
+        table[node] = GeneratePath(config, node);
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  return table;
+}
+
+/**
+ * @brief ns-2 movements of @p node following @p path, which
+ *        Ns2MobilityHelper and ParseNs2() turn back into the same path.
+ */
+inline std::string
+FormatNs2(uint32_t node, const std::vector<Waypoint>& path)
+{
+  std::string text;
+  char line[160];
+  if (path.empty())
+    return text;
+  snprintf(line, sizeof(line), "$node_(%u) set X_ %.17g\n$node_(%u) set Y_ %.17g\n",
+           node, path[0].x, node, path[0].y);
+  text += line;
+  for (size_t k = 1; k < path.size(); ++k) {
+    const Waypoint& from = path[k - 1];
+    const Waypoint& to = path[k];
+    double distance = std::hypot(to.x - from.x, to.y - from.y);
+    if (distance == 0 || to.t <= from.t)
+      continue;
+    snprintf(line, sizeof(line), "$ns_ at %.17g \"$node_(%u) setdest %.17g %.17g %.17g\"\n",
+             from.t, node, to.x, to.y, distance / (to.t - from.t));
+    text += line;
+  }
+  return text;
+}
+
+}  // namespace mobility
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_MOBILITY_GENERATOR_HPP_
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_COMMON_MOBILITY_NS3_WAYPOINT_MOBILITY_HPP_
+#define SYNC_COMMON_MOBILITY_NS3_WAYPOINT_MOBILITY_HPP_
+
+#include "ns3/mobility-module.h"
+#include "ns3/node-list.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "mobility/waypoint-table.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Give every node listed in @p file a WaypointMobilityModel with its
+ *        path, like Ns2MobilityHelper::Install() does for the text trace.
+ */
+inline void
+InstallWaypoints(const ::ndn::mobility::WaypointFile& file)
+{
+  for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i) {
+    uint32_t id = (*i)->GetId();
+    if (id >= file.Nodes() || file.Begin(id) == file.End(id))
+      continue;
+    Ptr<WaypointMobilityModel> model = (*i)->GetObject<WaypointMobilityModel>();
+    if (model == 0) {
+      model = CreateObject<WaypointMobilityModel>();
+      (*i)->AggregateObject(model);
+    }
+    for (const auto* w = file.Begin(id); w != file.End(id); ++w)
+      model->AddWaypoint(ns3::Waypoint(Seconds(w->t), Vector(w->x, w->y, w->z)));
+  }
+}
+
+/**
+ * @brief Install the ns-2 movements of @p trace, from the table that
+ *        mobility-convert compiled from it if there is one.
+ *
+ * The table of "trace/scenario-20.ns_movements" is "trace/scenario-20.wpt".
+ * A table that is damaged or older than the trace is ignored with a
+ * warning, and the trace is parsed instead.
+ */
+inline void
+InstallMobilityTrace(const std::string& trace)
+{
+  std::string table = trace.substr(0, trace.rfind('.')) + ".wpt";
+  ::ndn::mobility::WaypointFile file;
+  std::string error;
+  if (file.Open(table, error)) {
+    std::ifstream source(trace.c_str());
+    if (!source || file.MatchesSource(trace)) {
+      InstallWaypoints(file);
+      return;
+    }
+    std::cerr << "Ignoring " << table << ", converted from an older " << trace
+              << "; run mobility-convert again" << std::endl;
+  }
+  else if (std::ifstream(table.c_str())) {
+    std::cerr << "Ignoring " << error << std::endl;
+  }
+  Ns2MobilityHelper(trace).Install();
+}
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // SYNC_COMMON_MOBILITY_NS3_WAYPOINT_MOBILITY_HPP_
@@ -0,0 +1,429 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Binary waypoint tables, compiled once from ns-2 movement traces so that
+ * simulation runs can map them into memory instead of parsing the text.
+ *
+ * A table holds the piecewise-linear path of every node as waypoints sorted
+ * by time, which is exactly how Ns2MobilityHelper moves the nodes: a node
+ * heads for its "setdest" target at the given speed, stops on arrival, and
+ * changes course at its next command. A "set X_" at a later time makes it
+ * jump, as a waypoint kJumpTime after the one it jumps from: waypoint times
+ * are strictly ascending, as WaypointMobilityModel requires.
+ *
+ * File layout, little-endian as written by the host:
+ *
+ *   FileHeader
+ *   uint64_t offsets[nodes + 1]    waypoints of node i are [offsets[i], offsets[i + 1])
+ *   Waypoint waypoints[]
+ *
+ * The header carries the size and FNV-1a hash of the ns-2 text it was
+ * converted from, to detect stale conversions, and the hash of everything
+ * after it, to detect truncated or damaged files.
+ *
+ * See mobility-convert.cpp for the converter and ns3-waypoint-mobility.hpp
+ * for installing a table as WaypointMobilityModels.
+ */
+
+#ifndef SYNC_COMMON_MOBILITY_WAYPOINT_TABLE_HPP_
+#define SYNC_COMMON_MOBILITY_WAYPOINT_TABLE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <istream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace ndn {
+namespace mobility {
+
+struct Waypoint {
+  double t;
+  double x;
+  double y;
+  double z;
+};
+
+/* Waypoints of each node, by node id */
+using WaypointTable = std::vector<std::vector<Waypoint>>;
+
+struct FileHeader {
+  char magic[8];              /* "NDNWAYPT" */
+  uint32_t version;
+  uint32_t nodes;
+  uint64_t waypoints;
+  uint64_t source_size;
+  uint64_t source_hash;
+  uint64_t payload_hash;
+};
+
+static const char kMagic[8] = {'N', 'D', 'N', 'W', 'A', 'Y', 'P', 'T'};
+static const uint32_t kVersion = 2;   /* 1 had jumps as waypoints of the same time */
+
+/* Seconds a jump takes */
+static const double kJumpTime = 1e-6;
+
+inline uint64_t
+Fnv1a(const char* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+namespace detail {
+
+/* Motion of one node while its ns-2 commands are replayed */
+struct NodeState {
+  double x = 0, y = 0, z = 0;         /* Position at t0 */
+  double t0 = 0;
+  double dx = 0, dy = 0, dz = 0;      /* Destination */
+  double speed = 0;
+  double arrival = 0;                 /* At destination, t0 if not moving */
+  bool moving = false;
+
+  void
+  PositionAt(double t, double& px, double& py, double& pz) const
+  {
+    if (!moving || t >= arrival) {
+      px = moving ? dx : x;
+      py = moving ? dy : y;
+      pz = moving ? dz : z;
+      return;
+    }
+    double f = (t - t0) / (arrival - t0);
+    px = x + (dx - x) * f;
+    py = y + (dy - y) * f;
+    pz = z + (dz - z) * f;
+  }
+};
+
+struct Command {
+  double t;
+  uint32_t node;
+  bool setdest;
+  char axis;                /* 'X', 'Y' or 'Z' of "set" */
+  double a, b, c;           /* setdest: x, y, speed; set: value */
+};
+
+inline void
+Append(std::vector<Waypoint>& waypoints, double t, double x, double y, double z)
+{
+  if (!waypoints.empty()) {
+    const Waypoint& last = waypoints.back();
+    if (t <= last.t) {
+      if (last.x == x && last.y == y && last.z == z)
+        return;
+      t = last.t + kJumpTime;
+    }
+  }
+  waypoints.push_back({t, x, y, z});
+}
+
+/* "$node_(12)" -> 12 */
+inline bool
+ParseNode(const std::string& word, uint32_t& node)
+{
+  size_t open = word.find("$node_(");
+  if (open == std::string::npos)
+    return false;
+  char* end = nullptr;
+  const char* begin = word.c_str() + open + 7;
+  unsigned long id = std::strtoul(begin, &end, 10);
+  if (end == begin || *end != ')')
+    return false;
+  node = static_cast<uint32_t>(id);
+  return true;
+}
+
+inline bool
+ParseDouble(const std::string& word, double& value)
+{
+  char* end = nullptr;
+  value = std::strtod(word.c_str(), &end);
+  return end != word.c_str() && (*end == '\0' || *end == '"');
+}
+
+}  // namespace detail
+
+/**
+ * @brief Compile the ns-2 movements read from @p in into @p table.
+ * @return false with @p error set on a malformed line
+ */
+inline bool
+ParseNs2(std::istream& in, WaypointTable& table, std::string& error)
+{
+  std::vector<detail::NodeState> nodes;
+  std::vector<detail::Command> commands;
+  std::string line;
+  for (int lineno = 1; std::getline(in, line); ++lineno) {
+    std::istringstream words(line);
+    std::vector<std::string> w{std::istream_iterator<std::string>(words),
+                               std::istream_iterator<std::string>()};
+    if (w.empty() || w[0][0] == '#')
+      continue;
+    detail::Command cmd = {0, 0, false, 0, 0, 0, 0};
+    bool ok;
+    bool timed = w[0] == "$ns_";
+    if (timed) {
+      /* $ns_ at T "$node_(N) setdest X Y S" or $ns_ at T "$node_(N) set X_ V" */
+      ok = w.size() >= 6 && w[1] == "at" && detail::ParseDouble(w[2], cmd.t) &&
+           detail::ParseNode(w[3], cmd.node);
+      if (ok && w[4] == "setdest") {
+        cmd.setdest = true;
+        ok = w.size() == 8 && detail::ParseDouble(w[5], cmd.a) &&
+             detail::ParseDouble(w[6], cmd.b) && detail::ParseDouble(w[7], cmd.c);
+      }
+      else if (ok && w[4] == "set") {
+        ok = w.size() == 7 && w[5].size() == 2 && w[5][1] == '_' &&
+             detail::ParseDouble(w[6], cmd.a);
+        cmd.axis = ok ? w[5][0] : 0;
+      }
+      else {
+        ok = false;
+      }
+    }
+    else {
+      /* $node_(N) set X_ V, at the start */
+      ok = w.size() == 4 && detail::ParseNode(w[0], cmd.node) && w[1] == "set" &&
+           w[2].size() == 2 && w[2][1] == '_' && detail::ParseDouble(w[3], cmd.a);
+      cmd.axis = ok ? w[2][0] : 0;
+    }
+    if (ok && !cmd.setdest)
+      ok = cmd.axis == 'X' || cmd.axis == 'Y' || cmd.axis == 'Z';
+    if (!ok) {
+      error = "line " + std::to_string(lineno) + ": cannot parse \"" + line + "\"";
+      return false;
+    }
+    if (cmd.node >= nodes.size())
+      nodes.resize(cmd.node + 1);
+    if (timed) {
+      commands.push_back(cmd);
+      continue;
+    }
+    detail::NodeState& state = nodes[cmd.node];
+    (cmd.axis == 'X' ? state.x : cmd.axis == 'Y' ? state.y : state.z) = cmd.a;
+  }
+
+  table.assign(nodes.size(), std::vector<Waypoint>());
+  for (uint32_t node = 0; node < nodes.size(); ++node)
+    detail::Append(table[node], 0, nodes[node].x, nodes[node].y, nodes[node].z);
+
+  /* Replay in time order, like the simulator would */
+  std::stable_sort(commands.begin(), commands.end(),
+                   [] (const detail::Command& a, const detail::Command& b) {
+                     return a.t < b.t;
+                   });
+  for (const auto& cmd : commands) {
+    detail::NodeState& state = nodes[cmd.node];
+    std::vector<Waypoint>& waypoints = table[cmd.node];
+    if (state.moving && state.arrival < cmd.t)
+      detail::Append(waypoints, state.arrival, state.dx, state.dy, state.dz);
+    double x, y, z;
+    state.PositionAt(cmd.t, x, y, z);
+    detail::Append(waypoints, cmd.t, x, y, z);
+    state.x = x;
+    state.y = y;
+    state.z = z;
+    state.t0 = cmd.t;
+    state.moving = false;
+    if (cmd.setdest) {
+      double distance = std::sqrt((cmd.a - x) * (cmd.a - x) + (cmd.b - y) * (cmd.b - y));
+      if (cmd.c > 0 && distance > 0) {
+        state.dx = cmd.a;
+        state.dy = cmd.b;
+        state.dz = z;
+        state.arrival = cmd.t + distance / cmd.c;
+        state.moving = true;
+      }
+    }
+    else {
+      (cmd.axis == 'X' ? state.x : cmd.axis == 'Y' ? state.y : state.z) = cmd.a;
+      detail::Append(waypoints, cmd.t, state.x, state.y, state.z);
+    }
+  }
+  for (uint32_t node = 0; node < nodes.size(); ++node) {
+    if (nodes[node].moving)
+      detail::Append(table[node], nodes[node].arrival, nodes[node].dx, nodes[node].dy,
+                     nodes[node].dz);
+  }
+  return true;
+}
+
+/**
+ * @brief Write @p table to @p path, converted from @p source_size bytes of
+ *        ns-2 text hashing to @p source_hash.
+ */
+inline bool
+WriteTable(const std::string& path, const WaypointTable& table,
+           uint64_t source_size, uint64_t source_hash)
+{
+  std::vector<uint64_t> offsets(1, 0);
+  for (const auto& waypoints : table)
+    offsets.push_back(offsets.back() + waypoints.size());
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.nodes = table.size();
+  header.waypoints = offsets.back();
+  header.source_size = source_size;
+  header.source_hash = source_hash;
+  uint64_t hash = Fnv1a(reinterpret_cast<const char*>(offsets.data()),
+                        offsets.size() * sizeof(uint64_t));
+  for (const auto& waypoints : table)
+    hash = Fnv1a(reinterpret_cast<const char*>(waypoints.data()),
+                 waypoints.size() * sizeof(Waypoint), hash);
+  header.payload_hash = hash;
+
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+            std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+  for (const auto& waypoints : table) {
+    if (ok && !waypoints.empty())
+      ok = std::fwrite(waypoints.data(), sizeof(Waypoint), waypoints.size(), file) ==
+           waypoints.size();
+  }
+  return std::fclose(file) == 0 && ok;
+}
+
+/**
+ * @brief Size and FNV-1a hash of the file at @p path.
+ */
+inline bool
+HashFile(const std::string& path, uint64_t& size, uint64_t& hash)
+{
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  char buffer[1 << 16];
+  size = 0;
+  hash = Fnv1a(nullptr, 0);
+  size_t n;
+  while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    hash = Fnv1a(buffer, n, hash);
+    size += n;
+  }
+  bool ok = !std::ferror(file);
+  std::fclose(file);
+  return ok;
+}
+
+/**
+ * @brief Read-only mapping of a waypoint table file.
+ */
+class WaypointFile {
+ public:
+  WaypointFile() : data_(nullptr), size_(0), header_(nullptr) {}
+
+  ~WaypointFile() {
+    if (data_ != nullptr)
+      munmap(const_cast<char*>(data_), size_);
+  }
+
+  /**
+   * @return false with @p error set if the file cannot be mapped or is not
+   *         an intact table
+   */
+  bool
+  Open(const std::string& path, std::string& error)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      error = "cannot open " + path;
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(FileHeader)) {
+      size_ = st.st_size;
+      void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      data_ = data == MAP_FAILED ? nullptr : static_cast<const char*>(data);
+    }
+    close(fd);
+    if (data_ == nullptr) {
+      error = "cannot map " + path;
+      return false;
+    }
+
+    header_ = reinterpret_cast<const FileHeader*>(data_);
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+        header_->version != kVersion) {
+      error = path + " is not a version " + std::to_string(kVersion) + " waypoint table";
+      return false;
+    }
+    size_t expected = sizeof(FileHeader) + (header_->nodes + 1) * sizeof(uint64_t) +
+                      header_->waypoints * sizeof(Waypoint);
+    if (size_ != expected ||
+        Offsets()[header_->nodes] != header_->waypoints ||
+        Fnv1a(data_ + sizeof(FileHeader), size_ - sizeof(FileHeader)) != header_->payload_hash) {
+      error = path + " is damaged";
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Whether the table was converted from the current contents of
+   *        the ns-2 trace at @p source.
+   */
+  bool
+  MatchesSource(const std::string& source) const
+  {
+    uint64_t size, hash;
+    return HashFile(source, size, hash) && size == header_->source_size &&
+           hash == header_->source_hash;
+  }
+
+  uint32_t Nodes() const { return header_->nodes; }
+  uint64_t Waypoints() const { return header_->waypoints; }
+
+  const Waypoint*
+  Begin(uint32_t node) const
+  {
+    return Table() + Offsets()[node];
+  }
+
+  const Waypoint*
+  End(uint32_t node) const
+  {
+    return Table() + Offsets()[node + 1];
+  }
+
+ private:
+  WaypointFile(const WaypointFile&) = delete;
+  WaypointFile& operator=(const WaypointFile&) = delete;
+
+  const uint64_t*
+  Offsets() const
+  {
+    return reinterpret_cast<const uint64_t*>(data_ + sizeof(FileHeader));
+  }
+
+  const Waypoint*
+  Table() const
+  {
+    return reinterpret_cast<const Waypoint*>(Offsets() + header_->nodes + 1);
+  }
+
+  const char* data_;
+  size_t size_;
+  const FileHeader* header_;
+};
+
+}  // namespace mobility
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_MOBILITY_WAYPOINT_TABLE_HPP_
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Uniform grid index over moving points, for "who is within range of X"
+ * queries that would otherwise scan every node.
+ *
+ * Each point moves at constant velocity between updates, which is how the
+ * ns-3 mobility models behave between course changes. A point is binned by
+ * its position when it was last updated or rebinned; as it drifts away from
+ * that cell, queries widen their search by the largest possible drift, and
+ * once that exceeds half a cell every point is rebinned. With the cell size
+ * close to the query radius a query visits a handful of cells, and a point
+ * is only rebinned every cell_size / (2 * max speed) seconds.
+ *
+ * Header-only so that any of the simulations can use it, see
+ * DDSN/extensions/mobility-grid for the ns-3 side.
+ */
+
+#ifndef SYNC_COMMON_SPATIAL_GRID_HPP_
+#define SYNC_COMMON_SPATIAL_GRID_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ndn {
+namespace spatial {
+
+class SpatialGrid {
+ public:
+  using Id = uint32_t;
+
+  explicit SpatialGrid(double cell_size)
+    : cell_size_(cell_size)
+    , size_(0)
+    , epoch_(0)
+    , max_speed_(0)
+    , rebins_(0)
+  {
+  }
+
+  /**
+   * @brief Set the position of @p id at time @p now and its velocity from
+   *        then on. Adds @p id if it is new.
+   */
+  void
+  Update(Id id, double now, double x, double y, double z,
+         double vx, double vy, double vz)
+  {
+    if (id >= entries_.size())
+      entries_.resize(id + 1);
+    Entry& e = entries_[id];
+    e.x = x;
+    e.y = y;
+    e.z = z;
+    e.vx = vx;
+    e.vy = vy;
+    e.vz = vz;
+    e.t = now;
+    max_speed_ = std::max(max_speed_, Speed(e));
+    uint64_t cell = CellOf(x, y);
+    if (!e.present) {
+      e.present = true;
+      Insert(id, cell);
+      ++size_;
+    }
+    else if (cell != e.cell) {
+      Erase(id);
+      Insert(id, cell);
+    }
+  }
+
+  void
+  Remove(Id id)
+  {
+    if (id >= entries_.size() || !entries_[id].present)
+      return;
+    Erase(id);
+    entries_[id].present = false;
+    --size_;
+  }
+
+  /**
+   * @brief Call f(id) for every point within @p radius of (x, y, z) at
+   *        time @p now, which must not go back in time.
+   */
+  template <typename F>
+  void
+  ForEachWithin(double now, double x, double y, double z, double radius, F f)
+  {
+    double drift = max_speed_ * (now - epoch_);
+    if (drift > cell_size_ / 2) {
+      Rebin(now);
+      drift = 0;
+    }
+    double reach = radius + drift;
+    int64_t x_first = CellIndex(x - reach), x_last = CellIndex(x + reach);
+    int64_t y_first = CellIndex(y - reach), y_last = CellIndex(y + reach);
+    for (int64_t cx = x_first; cx <= x_last; ++cx) {
+      for (int64_t cy = y_first; cy <= y_last; ++cy) {
+        auto it = cells_.find(Key(cx, cy));
+        if (it == cells_.end())
+          continue;
+        for (Id id : it->second) {
+          const Entry& e = entries_[id];
+          double dt = now - e.t;
+          double dx = e.x + e.vx * dt - x;
+          double dy = e.y + e.vy * dt - y;
+          double dz = e.z + e.vz * dt - z;
+          if (dx * dx + dy * dy + dz * dz <= radius * radius)
+            f(id);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Number of points other than @p self within @p radius of (x, y, z).
+   */
+  size_t
+  CountWithin(double now, double x, double y, double z, double radius, Id self)
+  {
+    size_t count = 0;
+    ForEachWithin(now, x, y, z, radius, [&count, self] (Id id) {
+      if (id != self)
+        ++count;
+    });
+    return count;
+  }
+
+  size_t Size() const { return size_; }
+
+  /* Times every point was rebinned, for tuning the cell size */
+  uint64_t Rebins() const { return rebins_; }
+
+ private:
+  struct Entry {
+    bool present = false;
+    double x, y, z;
+    double vx, vy, vz;
+    double t;               /* Time of (x, y, z) */
+    uint64_t cell;
+    size_t slot;            /* Index in cells_[cell] */
+  };
+
+  static double
+  Speed(const Entry& e)
+  {
+    return std::sqrt(e.vx * e.vx + e.vy * e.vy);
+  }
+
+  static uint64_t
+  Key(int64_t cx, int64_t cy)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint32_t>(cy);
+  }
+
+  int64_t
+  CellIndex(double coordinate) const
+  {
+    return static_cast<int64_t>(std::floor(coordinate / cell_size_));
+  }
+
+  uint64_t
+  CellOf(double x, double y) const
+  {
+    return Key(CellIndex(x), CellIndex(y));
+  }
+
+  void
+  Insert(Id id, uint64_t cell)
+  {
+    std::vector<Id>& ids = cells_[cell];
+    entries_[id].cell = cell;
+    entries_[id].slot = ids.size();
+    ids.push_back(id);
+  }
+
+  void
+  Erase(Id id)
+  {
+    const Entry& e = entries_[id];
+    std::vector<Id>& ids = cells_[e.cell];
+    ids[e.slot] = ids.back();
+    entries_[ids[e.slot]].slot = e.slot;
+    ids.pop_back();
+  }
+
+  /* Move every point to the cell of its position at @p now */
+  void
+  Rebin(double now)
+  {
+    max_speed_ = 0;
+    for (Id id = 0; id < entries_.size(); ++id) {
+      const Entry& e = entries_[id];
+      if (!e.present)
+        continue;
+      max_speed_ = std::max(max_speed_, Speed(e));
+      double dt = now - e.t;
+      uint64_t cell = CellOf(e.x + e.vx * dt, e.y + e.vy * dt);
+      if (cell != e.cell) {
+        Erase(id);
+        Insert(id, cell);
+      }
+    }
+    epoch_ = now;
+    ++rebins_;
+  }
+
+  const double cell_size_;
+  std::vector<Entry> entries_;
+  std::unordered_map<uint64_t, std::vector<Id>> cells_;
+  size_t size_;
+  double epoch_;            /* Every point was binned at or after this time */
+  double max_speed_;        /* Fastest point since epoch_ */
+  uint64_t rebins_;
+};
+
+}  // namespace spatial
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_SPATIAL_GRID_HPP_
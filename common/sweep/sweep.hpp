@@ -0,0 +1,279 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Parameter sweeps of simulation runs: the sweep spec, its expansion into
+ * points and runs, and the statistics across seeds. The runner itself is
+ * sync-sweep.cpp.
+ *
+ * A spec has one setting per line; "#" starts a comment:
+ *
+ *   command = ./build/sync-for-sleep-movepattern --eventLog={dir}/output.events
+ *   analyze = ./build/sync-analyzer {dir}/output.txt {dir}/output.events
+ *   env NS_LOG = SyncForSleep
+ *   param lossRate = 0.0 0.05 0.2 0.5
+ *   param wifiRange = 60 80
+ *   seed run = 1-12
+ *
+ * Every combination of param values is a point, and every point runs once
+ * per seed with "--<param>=<value>" and "--<seed name>=<seed>" appended to
+ * the command. {dir} is the run's own directory, which receives its output
+ * as output.txt and the JSON printed by the analyze command as stats.json.
+ */
+
+#ifndef SYNC_COMMON_SWEEP_HPP_
+#define SYNC_COMMON_SWEEP_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ndn {
+namespace sweep {
+
+struct SweepSpec {
+  std::string command;
+  std::string analyze;                          /* Optional */
+  std::vector<std::pair<std::string, std::string>> env;
+  std::vector<std::pair<std::string, std::vector<std::string>>> params;
+  std::string seed_name;
+  std::vector<uint64_t> seeds;
+};
+
+namespace detail {
+
+inline std::string
+Trim(const std::string& s)
+{
+  size_t begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return "";
+  return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+inline std::vector<std::string>
+Split(const std::string& s)
+{
+  std::istringstream in(s);
+  std::vector<std::string> words;
+  std::string word;
+  while (in >> word)
+    words.push_back(word);
+  return words;
+}
+
+/**
+ * @brief Parse "3", "1-12" or "1 2 5-7" into @p seeds.
+ */
+inline bool
+ParseSeeds(const std::string& s, std::vector<uint64_t>& seeds)
+{
+  for (const auto& word : Split(s)) {
+    char* end = nullptr;
+    uint64_t first = std::strtoull(word.c_str(), &end, 10);
+    uint64_t last = first;
+    if (*end == '-')
+      last = std::strtoull(end + 1, &end, 10);
+    if (end == word.c_str() || *end != '\0' || last < first)
+      return false;
+    for (uint64_t seed = first; seed <= last; ++seed)
+      seeds.push_back(seed);
+  }
+  return !seeds.empty();
+}
+
+}  // namespace detail
+
+/**
+ * @brief Read a spec from @p in.
+ * @return false with @p error set if the spec is malformed
+ */
+inline bool
+ParseSpec(std::istream& in, SweepSpec& spec, std::string& error)
+{
+  std::string line;
+  for (int lineno = 1; std::getline(in, line); ++lineno) {
+    line = detail::Trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+    size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      error = "line " + std::to_string(lineno) + ": expected \"key = value\"";
+      return false;
+    }
+    std::vector<std::string> key = detail::Split(line.substr(0, eq));
+    std::string value = detail::Trim(line.substr(eq + 1));
+    if (key.size() == 1 && key[0] == "command") {
+      spec.command = value;
+    }
+    else if (key.size() == 1 && key[0] == "analyze") {
+      spec.analyze = value;
+    }
+    else if (key.size() == 2 && key[0] == "env") {
+      spec.env.emplace_back(key[1], value);
+    }
+    else if (key.size() == 2 && key[0] == "param" && !detail::Split(value).empty()) {
+      spec.params.emplace_back(key[1], detail::Split(value));
+    }
+    else if (key.size() == 2 && key[0] == "seed" && detail::ParseSeeds(value, spec.seeds)) {
+      spec.seed_name = key[1];
+    }
+    else {
+      error = "line " + std::to_string(lineno) + ": bad setting \"" + line + "\"";
+      return false;
+    }
+  }
+  if (spec.command.empty()) {
+    error = "no command";
+    return false;
+  }
+  if (spec.seeds.empty()) {
+    spec.seed_name = "RngRun";      /* ns-3 global, works for any scenario */
+    spec.seeds.push_back(1);
+  }
+  return true;
+}
+
+/**
+ * @brief One combination of param values.
+ */
+struct Point {
+  std::vector<std::pair<std::string, std::string>> values;
+
+  /**
+   * @brief Directory name, e.g. "lossRate_0.05-wifiRange_60".
+   */
+  std::string
+  Name() const
+  {
+    std::string name;
+    for (const auto& value : values)
+      name += (name.empty() ? "" : "-") + value.first + "_" + value.second;
+    return name.empty() ? "default" : name;
+  }
+
+  std::string
+  Args() const
+  {
+    std::string args;
+    for (const auto& value : values)
+      args += " --" + value.first + "=" + value.second;
+    return args;
+  }
+};
+
+/**
+ * @brief All points of @p spec, the last param varying fastest.
+ */
+inline std::vector<Point>
+ExpandPoints(const SweepSpec& spec)
+{
+  std::vector<Point> points(1);
+  for (const auto& param : spec.params) {
+    std::vector<Point> next;
+    for (const auto& point : points) {
+      for (const auto& value : param.second) {
+        Point p = point;
+        p.values.emplace_back(param.first, value);
+        next.push_back(p);
+      }
+    }
+    points.swap(next);
+  }
+  return points;
+}
+
+/**
+ * @brief Replace every "{dir}" in @p command with @p dir.
+ */
+inline std::string
+SubstituteDir(std::string command, const std::string& dir)
+{
+  const std::string kDir = "{dir}";
+  for (size_t pos = command.find(kDir); pos != std::string::npos;
+       pos = command.find(kDir, pos + dir.size()))
+    command.replace(pos, kDir.size(), dir);
+  return command;
+}
+
+/**
+ * @brief Numbers of a flat JSON object such as sync-analyzer prints. Nulls
+ *        and other values are skipped.
+ */
+inline std::map<std::string, double>
+ParseFlatJson(const std::string& json)
+{
+  std::map<std::string, double> values;
+  size_t pos = 0;
+  while ((pos = json.find('"', pos)) != std::string::npos) {
+    size_t end = json.find('"', pos + 1);
+    if (end == std::string::npos)
+      break;
+    std::string key = json.substr(pos + 1, end - pos - 1);
+    pos = json.find_first_not_of(" \t\r\n", end + 1);
+    if (pos == std::string::npos || json[pos] != ':')
+      continue;
+    const char* begin = json.c_str() + pos + 1;
+    char* stop = nullptr;
+    double value = std::strtod(begin, &stop);
+    if (stop != begin)
+      values[key] = value;
+    pos = stop - json.c_str();
+  }
+  return values;
+}
+
+/**
+ * @brief Two-sided 95% quantile of Student's t distribution.
+ */
+inline double
+StudentT95(size_t df)
+{
+  static const double kTable[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if (df == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+  return df <= 30 ? kTable[df - 1] : 1.96;
+}
+
+struct Summary {
+  size_t n;
+  double mean;
+  double stddev;      /* Sample standard deviation */
+  double ci95;        /* Half-width of the 95% confidence interval of the mean */
+};
+
+inline Summary
+Summarize(const std::vector<double>& values)
+{
+  Summary summary = {values.size(), std::numeric_limits<double>::quiet_NaN(),
+                     std::numeric_limits<double>::quiet_NaN(),
+                     std::numeric_limits<double>::quiet_NaN()};
+  if (values.empty())
+    return summary;
+  double sum = 0;
+  for (double value : values)
+    sum += value;
+  summary.mean = sum / values.size();
+  if (values.size() < 2)
+    return summary;
+  double squares = 0;
+  for (double value : values)
+    squares += (value - summary.mean) * (value - summary.mean);
+  summary.stddev = std::sqrt(squares / (values.size() - 1));
+  summary.ci95 = StudentT95(values.size() - 1) * summary.stddev / std::sqrt(values.size());
+  return summary;
+}
+
+}  // namespace sweep
+}  // namespace ndn
+
+#endif  // SYNC_COMMON_SWEEP_HPP_
@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+/**
+ * Run a parameter sweep of simulations in parallel, see sweep.hpp for the
+ * spec format:
+ *
+ *   sync-sweep [--jobs=N] [--retries=N] [--no-pin] <spec> <output dir>
+ *
+ * Up to N runs (default: one per CPU) execute at once, each pinned to its
+ * own CPU, in <output dir>/<point>/run_<seed>/. A run that crashes or exits
+ * non-zero is retried. Runs already done are skipped, so an interrupted
+ * sweep resumes where it stopped. Finally the stats.json of all runs are
+ * aggregated into <output dir>/summary.csv with one row per point and
+ * metric: mean, standard deviation and 95% confidence interval across seeds.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "sweep/sweep.hpp"
+
+using namespace ndn::sweep;
+
+namespace {
+
+struct Run {
+  size_t point;
+  uint64_t seed;
+  std::string dir;
+  bool ok;
+};
+
+std::mutex g_print_mutex;
+
+bool
+MakeDirs(const std::string& path) {
+  for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+    std::string prefix = path.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+    if (pos == std::string::npos)
+      return true;
+  }
+}
+
+bool
+Exists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+std::string
+ShellQuote(const std::string& s) {
+  std::string quoted = "'";
+  for (char c : s)
+    quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+  return quoted + "'";
+}
+
+/**
+ * @brief Run @p command with /bin/sh, its stdout and stderr going to
+ *        @p output, on @p cpu unless negative.
+ * @return true if it exited with status 0
+ */
+bool
+Execute(const std::string& command, const std::string& output, bool with_stderr, int cpu) {
+  int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+  pid_t pid = fork();
+  if (pid == 0) {
+    if (cpu >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      sched_setaffinity(0, sizeof(set), &set);
+    }
+    dup2(fd, STDOUT_FILENO);
+    if (with_stderr)
+      dup2(fd, STDERR_FILENO);
+    close(fd);
+    execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+  }
+  close(fd);
+  if (pid < 0)
+    return false;
+  int status;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR)
+      return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief CPUs this process may run on, in order.
+ */
+std::vector<int>
+AllowedCpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set))
+        cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+void
+ExecuteRun(const SweepSpec& spec, const std::string& env, const Point& point,
+           int retries, int cpu, Run& run) {
+  const std::string done = run.dir + "/done";
+  if (Exists(done)) {
+    run.ok = true;
+    return;
+  }
+  std::string command = env + SubstituteDir(spec.command, run.dir) + point.Args() +
+                        " --" + spec.seed_name + "=" + std::to_string(run.seed);
+  run.ok = false;
+  for (int attempt = 0; attempt <= retries && !run.ok; ++attempt) {
+    {
+      std::lock_guard<std::mutex> lock(g_print_mutex);
+      printf("%s %s\n", attempt == 0 ? "Starting" : "Retrying", run.dir.c_str());
+      fflush(stdout);
+    }
+    run.ok = Execute(command, run.dir + "/output.txt", true, cpu);
+  }
+  if (run.ok && !spec.analyze.empty())
+    run.ok = Execute(SubstituteDir(spec.analyze, run.dir), run.dir + "/stats.json", false, cpu);
+  if (run.ok)
+    std::ofstream(done.c_str());
+
+  std::lock_guard<std::mutex> lock(g_print_mutex);
+  printf("%s %s\n", run.ok ? "Finished" : "FAILED", run.dir.c_str());
+  fflush(stdout);
+}
+
+bool
+WriteSummary(const SweepSpec& spec, const std::vector<Point>& points,
+             const std::vector<Run>& runs, const std::string& path) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == nullptr)
+    return false;
+  fprintf(file, "point");
+  for (const auto& param : spec.params)
+    fprintf(file, ",%s", param.first.c_str());
+  fprintf(file, ",metric,n,mean,stddev,ci95\n");
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    std::map<std::string, std::vector<double>> values;
+    for (const auto& run : runs) {
+      if (run.point != i || !run.ok)
+        continue;
+      std::ifstream in((run.dir + "/stats.json").c_str());
+      std::stringstream json;
+      json << in.rdbuf();
+      for (const auto& metric : ParseFlatJson(json.str())) {
+        if (std::isfinite(metric.second))
+          values[metric.first].push_back(metric.second);
+      }
+    }
+    for (const auto& metric : values) {
+      Summary summary = Summarize(metric.second);
+      fprintf(file, "%s", points[i].Name().c_str());
+      for (const auto& value : points[i].values)
+        fprintf(file, ",%s", value.second.c_str());
+      fprintf(file, ",%s,%zu,%.10g,%.10g,%.10g\n", metric.first.c_str(), summary.n,
+              summary.mean, summary.stddev, summary.ci95);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+void
+Usage(const char* program) {
+  fprintf(stderr, "usage: %s [--jobs=N] [--retries=N] [--no-pin] <spec> <output dir>\n",
+          program);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::vector<int> cpus = AllowedCpus();
+  size_t jobs = std::max<size_t>(1, cpus.size());
+  int retries = 2;
+  bool pin = !cpus.empty();
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 7, "--jobs=") == 0)
+      jobs = std::max(1UL, std::strtoul(arg.c_str() + 7, nullptr, 10));
+    else if (arg.compare(0, 10, "--retries=") == 0)
+      retries = std::atoi(arg.c_str() + 10);
+    else if (arg == "--no-pin")
+      pin = false;
+    else if (arg.compare(0, 2, "--") != 0)
+      paths.push_back(arg);
+    else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (paths.size() != 2) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  SweepSpec spec;
+  std::string error;
+  std::ifstream in(paths[0].c_str());
+  if (!in) {
+    fprintf(stderr, "Cannot read %s\n", paths[0].c_str());
+    return 1;
+  }
+  if (!ParseSpec(in, spec, error)) {
+    fprintf(stderr, "%s: %s\n", paths[0].c_str(), error.c_str());
+    return 1;
+  }
+  std::string env;
+  for (const auto& var : spec.env)
+    env += var.first + "=" + ShellQuote(var.second) + " ";
+
+  std::vector<Point> points = ExpandPoints(spec);
+  std::vector<Run> runs;
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (uint64_t seed : spec.seeds) {
+      Run run = {i, seed, paths[1] + "/" + points[i].Name() + "/run_" + std::to_string(seed),
+                 false};
+      if (!MakeDirs(run.dir)) {
+        fprintf(stderr, "Cannot create %s\n", run.dir.c_str());
+        return 1;
+      }
+      runs.push_back(run);
+    }
+  }
+  printf("%zu points x %zu seeds on %zu jobs\n", points.size(), spec.seeds.size(), jobs);
+
+  /* Each worker owns a CPU and takes the next run when its own finishes */
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for (size_t slot = 0; slot < std::min(jobs, runs.size()); ++slot) {
+    int cpu = pin ? cpus[slot % cpus.size()] : -1;
+    workers.emplace_back([&, cpu] {
+      for (size_t i = next++; i < runs.size(); i = next++)
+        ExecuteRun(spec, env, points[runs[i].point], retries, cpu, runs[i]);
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  size_t failed = 0;
+  for (const auto& run : runs)
+    failed += run.ok ? 0 : 1;
+  const std::string summary = paths[1] + "/summary.csv";
+  if (!WriteSummary(spec, points, runs, summary)) {
+    fprintf(stderr, "Cannot write %s\n", summary.c_str());
+    return 1;
+  }
+  printf("%zu of %zu runs failed, summary in %s\n", failed, runs.size(), summary.c_str());
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "unit-disk-channel.hpp"
+#include "unit-disk-net-device.hpp"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ndn.UnitDiskChannel");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(UnitDiskChannel);
+
+TypeId
+UnitDiskChannel::GetTypeId()
+{
+  static TypeId tid = TypeId("UnitDiskChannel")
+    .SetParent<Channel>()
+    .AddConstructor<UnitDiskChannel>()
+    .AddAttribute("Range", "Devices within this distance (m) of the sender receive its frames",
+                  DoubleValue(100),
+                  MakeDoubleAccessor(&UnitDiskChannel::m_range),
+                  MakeDoubleChecker<double>(0))
+    .AddAttribute("DataRate", "Bit rate of the medium",
+                  DataRateValue(DataRate("11Mbps")),
+                  MakeDataRateAccessor(&UnitDiskChannel::m_dataRate),
+                  MakeDataRateChecker())
+    .AddAttribute("LossProbability", "Probability that a receiver loses a frame",
+                  DoubleValue(0),
+                  MakeDoubleAccessor(&UnitDiskChannel::m_lossProbability),
+                  MakeDoubleChecker<double>(0, 1));
+  return tid;
+}
+
+UnitDiskChannel::UnitDiskChannel()
+  : m_range(100)
+  , m_lossProbability(0)
+{
+}
+
+void
+UnitDiskChannel::Add(Ptr<UnitDiskNetDevice> device)
+{
+  NS_ASSERT_MSG(!m_grid, "Devices must be added before the first transmission");
+  m_devices.push_back(device);
+}
+
+UnitDiskChannel::DeviceIndex
+UnitDiskChannel::GetNDevices() const
+{
+  return m_devices.size();
+}
+
+Ptr<NetDevice>
+UnitDiskChannel::GetDevice(DeviceIndex i) const
+{
+  return m_devices[i];
+}
+
+Time
+UnitDiskChannel::Transmit(Ptr<UnitDiskNetDevice> sender, Ptr<const Packet> packet,
+                          uint16_t protocol, const Address& to)
+{
+  if (!m_grid)
+    IndexDevices();
+  Time duration = m_dataRate.CalculateBytesTxTime(packet->GetSize());
+  Vector pos = sender->GetNode()->GetObject<MobilityModel>()->GetPosition();
+  Address from = sender->GetAddress();
+  m_grid->ForEachWithin(Simulator::Now().GetSeconds(), pos.x, pos.y, pos.z, m_range,
+                        [&] (::ndn::spatial::SpatialGrid::Id i) {
+                          if (m_devices[i] != sender)
+                            m_devices[i]->StartReceive(packet, protocol, from, to, duration);
+                        });
+  return duration;
+}
+
+void
+UnitDiskChannel::IndexDevices()
+{
+  m_grid.reset(new ::ndn::spatial::SpatialGrid(m_range));
+  for (uint32_t i = 0; i < m_devices.size(); ++i) {
+    Ptr<Node> node = m_devices[i]->GetNode();
+    Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
+    NS_ABORT_MSG_IF(mobility == 0, "Node " << node->GetId() << " has no MobilityModel");
+    if (node->GetId() >= m_devicesOfNode.size())
+      m_devicesOfNode.resize(node->GetId() + 1);
+    /* One callback per node, however many of its devices share the channel */
+    if (m_devicesOfNode[node->GetId()].empty())
+      mobility->TraceConnectWithoutContext("CourseChange",
+                                           MakeCallback(&UnitDiskChannel::OnCourseChange, this));
+    m_devicesOfNode[node->GetId()].push_back(i);
+    UpdatePosition(mobility, i);
+  }
+  NS_LOG_DEBUG("Indexed " << m_devices.size() << " devices");
+}
+
+void
+UnitDiskChannel::OnCourseChange(Ptr<const MobilityModel> mobility)
+{
+  for (uint32_t i : m_devicesOfNode[mobility->GetObject<Node>()->GetId()])
+    UpdatePosition(mobility, i);
+}
+
+void
+UnitDiskChannel::UpdatePosition(Ptr<const MobilityModel> mobility, uint32_t i)
+{
+  Vector pos = mobility->GetPosition();
+  Vector vel = mobility->GetVelocity();
+  m_grid->Update(i, Simulator::Now().GetSeconds(), pos.x, pos.y, pos.z, vel.x, vel.y, vel.z);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_COMMON_UNIT_DISK_CHANNEL_HPP_
+#define SYNC_COMMON_UNIT_DISK_CHANNEL_HPP_
+
+#include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "spatial/spatial-grid.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class UnitDiskNetDevice;
+
+/**
+ * @brief Broadcast medium of the unit-disk fast mode: a frame reaches every
+ *        device within Range of the sender, after size / DataRate seconds.
+ *
+ * There is no propagation delay, fading or capture. Receivers find out
+ * about collisions and losses themselves, see UnitDiskNetDevice. Devices
+ * are found through a spatial grid that follows the MobilityModel of their
+ * nodes, so a frame costs one event per receiver in range.
+ */
+class UnitDiskChannel : public Channel
+{
+public:
+  /* Index type of Channel, which differs between ns-3 versions */
+  using DeviceIndex = decltype(std::declval<Channel>().GetNDevices());
+
+  static TypeId
+  GetTypeId();
+
+  UnitDiskChannel();
+
+  void
+  Add(Ptr<UnitDiskNetDevice> device);
+
+  virtual DeviceIndex
+  GetNDevices() const override;
+
+  virtual Ptr<NetDevice>
+  GetDevice(DeviceIndex i) const override;
+
+  /**
+   * @brief Start sending @p packet from @p sender to every device in range.
+   * @return Transmission time of the packet
+   */
+  Time
+  Transmit(Ptr<UnitDiskNetDevice> sender, Ptr<const Packet> packet, uint16_t protocol,
+           const Address& to);
+
+  double
+  GetLossProbability() const
+  {
+    return m_lossProbability;
+  }
+
+private:
+  /* Follow the mobility of every device's node, once the nodes have one */
+  void
+  IndexDevices();
+
+  void
+  OnCourseChange(Ptr<const MobilityModel> mobility);
+
+  void
+  UpdatePosition(Ptr<const MobilityModel> mobility, uint32_t i);
+
+  double m_range;
+  DataRate m_dataRate;
+  double m_lossProbability;
+  std::vector<Ptr<UnitDiskNetDevice>> m_devices;
+  std::vector<std::vector<uint32_t>> m_devicesOfNode;   /* By node id */
+  std::unique_ptr<::ndn::spatial::SpatialGrid> m_grid;  /* Of device indices, once indexed */
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // SYNC_COMMON_UNIT_DISK_CHANNEL_HPP_
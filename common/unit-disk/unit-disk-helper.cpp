@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "unit-disk-helper.hpp"
+
+#include "ns3/mac48-address.h"
+#include "ns3/node.h"
+
+namespace ns3 {
+namespace ndn {
+
+UnitDiskHelper::UnitDiskHelper()
+{
+  m_channelFactory.SetTypeId(UnitDiskChannel::GetTypeId());
+  m_deviceFactory.SetTypeId(UnitDiskNetDevice::GetTypeId());
+}
+
+void
+UnitDiskHelper::SetChannelAttribute(const std::string& name, const AttributeValue& value)
+{
+  m_channelFactory.Set(name, value);
+}
+
+void
+UnitDiskHelper::SetDeviceAttribute(const std::string& name, const AttributeValue& value)
+{
+  m_deviceFactory.Set(name, value);
+}
+
+NetDeviceContainer
+UnitDiskHelper::Install(const NodeContainer& nodes) const
+{
+  Ptr<UnitDiskChannel> channel = m_channelFactory.Create<UnitDiskChannel>();
+  NetDeviceContainer devices;
+  for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); ++i) {
+    Ptr<UnitDiskNetDevice> device = m_deviceFactory.Create<UnitDiskNetDevice>();
+    device->SetAddress(Mac48Address::Allocate());
+    (*i)->AddDevice(device);
+    device->SetChannel(channel);
+    devices.Add(device);
+  }
+  return devices;
+}
+
+int64_t
+UnitDiskHelper::AssignStreams(const NetDeviceContainer& devices, int64_t stream) const
+{
+  int64_t current = stream;
+  for (NetDeviceContainer::Iterator i = devices.Begin(); i != devices.End(); ++i) {
+    Ptr<UnitDiskNetDevice> device = DynamicCast<UnitDiskNetDevice>(*i);
+    if (device != 0)
+      current += device->AssignStreams(current);
+  }
+  return current - stream;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_COMMON_UNIT_DISK_HELPER_HPP_
+#define SYNC_COMMON_UNIT_DISK_HELPER_HPP_
+
+#include "ns3/attribute.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+
+#include <string>
+
+#include "unit-disk-channel.hpp"
+#include "unit-disk-net-device.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Installs UnitDiskNetDevices on one shared UnitDiskChannel, in place
+ *        of WifiHelper in the fast mode of the mobile scenarios.
+ *
+ * The NDN stack creates its faces on these devices like on wifi ones.
+ */
+class UnitDiskHelper
+{
+public:
+  UnitDiskHelper();
+
+  void
+  SetChannelAttribute(const std::string& name, const AttributeValue& value);
+
+  void
+  SetDeviceAttribute(const std::string& name, const AttributeValue& value);
+
+  /**
+   * @brief Give each of @p nodes a device on a new channel.
+   */
+  NetDeviceContainer
+  Install(const NodeContainer& nodes) const;
+
+  /**
+   * @brief Use fixed random streams for @p devices, from @p stream on.
+   * @return Number of streams used
+   */
+  int64_t
+  AssignStreams(const NetDeviceContainer& devices, int64_t stream) const;
+
+private:
+  ObjectFactory m_channelFactory;
+  ObjectFactory m_deviceFactory;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // SYNC_COMMON_UNIT_DISK_HELPER_HPP_
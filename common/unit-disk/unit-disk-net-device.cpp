@@ -0,0 +1,344 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#include "unit-disk-net-device.hpp"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.UnitDiskNetDevice");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(UnitDiskNetDevice);
+
+TypeId
+UnitDiskNetDevice::GetTypeId()
+{
+  static TypeId tid = TypeId("UnitDiskNetDevice")
+    .SetParent<NetDevice>()
+    .AddConstructor<UnitDiskNetDevice>()
+    .AddAttribute("Mtu", "Largest payload of a frame",
+                  UintegerValue(2296),
+                  MakeUintegerAccessor(&UnitDiskNetDevice::SetMtu,
+                                       &UnitDiskNetDevice::GetMtu),
+                  MakeUintegerChecker<uint16_t>())
+    .AddAttribute("MaxQueue", "Frames queued for sending, beyond which they are dropped",
+                  UintegerValue(400),
+                  MakeUintegerAccessor(&UnitDiskNetDevice::m_maxQueue),
+                  MakeUintegerChecker<uint32_t>(1))
+    .AddAttribute("SlotTime", "Duration of a backoff slot",
+                  TimeValue(MicroSeconds(20)),
+                  MakeTimeAccessor(&UnitDiskNetDevice::m_slot),
+                  MakeTimeChecker())
+    .AddAttribute("ContentionWindow", "Backoff is drawn from [0, ContentionWindow) slots",
+                  UintegerValue(32),
+                  MakeUintegerAccessor(&UnitDiskNetDevice::m_contentionWindow),
+                  MakeUintegerChecker<uint32_t>(1))
+    .AddTraceSource("Drop", "A frame was dropped because the queue was full",
+                    MakeTraceSourceAccessor(&UnitDiskNetDevice::m_dropTrace),
+                    "ns3::Packet::TracedCallback")
+    .AddTraceSource("Collision", "A frame was lost to an overlapping frame",
+                    MakeTraceSourceAccessor(&UnitDiskNetDevice::m_collisionTrace),
+                    "ns3::Packet::TracedCallback");
+  return tid;
+}
+
+UnitDiskNetDevice::UnitDiskNetDevice()
+  : m_ifIndex(0)
+  , m_mtu(2296)
+  , m_maxQueue(400)
+  , m_contentionWindow(32)
+  , m_random(CreateObject<UniformRandomVariable>())
+  , m_sending(false)
+{
+}
+
+void
+UnitDiskNetDevice::SetChannel(Ptr<UnitDiskChannel> channel)
+{
+  m_channel = channel;
+  m_channel->Add(this);
+}
+
+int64_t
+UnitDiskNetDevice::AssignStreams(int64_t stream)
+{
+  m_random->SetStream(stream);
+  return 1;
+}
+
+bool
+UnitDiskNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  return SendFrom(packet, m_address, dest, protocolNumber);
+}
+
+bool
+UnitDiskNetDevice::SendFrom(Ptr<Packet> packet, const Address& source, const Address& dest,
+                            uint16_t protocolNumber)
+{
+  if (m_queue.size() >= m_maxQueue) {
+    m_dropTrace(packet);
+    return false;
+  }
+  m_queue.push_back({packet, protocolNumber, Mac48Address::ConvertFrom(source),
+                     Mac48Address::ConvertFrom(dest)});
+  if (!m_sending)
+    StartBackoff();
+  return true;
+}
+
+void
+UnitDiskNetDevice::StartBackoff()
+{
+  m_sending = true;
+  uint32_t slots = m_random->GetInteger(0, m_contentionWindow - 1);
+  Simulator::Schedule(m_slot * slots, &UnitDiskNetDevice::TryTransmit, this);
+}
+
+void
+UnitDiskNetDevice::TryTransmit()
+{
+  /* Frames starting in this very slot are not heard yet, and will collide */
+  Time now = Simulator::Now();
+  Time busy_until = now;
+  for (const auto& reception : ActiveReceptions()) {
+    if (reception->start < now)
+      busy_until = std::max(busy_until, reception->end);
+  }
+  if (busy_until > now) {
+    Simulator::Schedule(busy_until - now, &UnitDiskNetDevice::StartBackoff, this);
+    return;
+  }
+
+  /* Half duplex: whatever this device was receiving is lost */
+  for (const auto& reception : m_receptions)
+    reception->collided = true;
+  const Frame& frame = m_queue.front();
+  Time duration = m_channel->Transmit(this, frame.packet, frame.protocol, frame.to);
+  m_txEnd = now + duration;
+  Simulator::Schedule(duration, &UnitDiskNetDevice::EndTransmit, this);
+}
+
+void
+UnitDiskNetDevice::EndTransmit()
+{
+  m_queue.pop_front();
+  m_sending = false;
+  if (!m_queue.empty())
+    StartBackoff();
+}
+
+void
+UnitDiskNetDevice::StartReceive(Ptr<const Packet> packet, uint16_t protocol, const Address& from,
+                                const Address& to, Time duration)
+{
+  Time now = Simulator::Now();
+  std::shared_ptr<Reception> reception = std::make_shared<Reception>();
+  reception->frame = {packet, protocol, Mac48Address::ConvertFrom(from),
+                      Mac48Address::ConvertFrom(to)};
+  reception->start = now;
+  reception->end = now + duration;
+  reception->collided = m_txEnd > now;
+  std::vector<std::shared_ptr<Reception>>& active = ActiveReceptions();
+  if (!active.empty()) {
+    reception->collided = true;
+    for (const auto& other : active)
+      other->collided = true;
+  }
+  active.push_back(reception);
+  Simulator::Schedule(duration, &UnitDiskNetDevice::EndReceive, this, reception);
+}
+
+void
+UnitDiskNetDevice::EndReceive(std::shared_ptr<Reception> reception)
+{
+  const Frame& frame = reception->frame;
+  if (reception->collided) {
+    m_collisionTrace(frame.packet);
+    return;
+  }
+  if (m_random->GetValue() < m_channel->GetLossProbability())
+    return;
+
+  NetDevice::PacketType type;
+  if (frame.to.IsBroadcast())
+    type = NetDevice::PACKET_BROADCAST;
+  else if (frame.to.IsGroup())
+    type = NetDevice::PACKET_MULTICAST;
+  else if (frame.to == m_address)
+    type = NetDevice::PACKET_HOST;
+  else
+    type = NetDevice::PACKET_OTHERHOST;
+
+  if (!m_promiscRxCallback.IsNull())
+    m_promiscRxCallback(this, frame.packet->Copy(), frame.protocol, frame.from, frame.to, type);
+  if (type != NetDevice::PACKET_OTHERHOST && !m_rxCallback.IsNull())
+    m_rxCallback(this, frame.packet->Copy(), frame.protocol, frame.from);
+}
+
+std::vector<std::shared_ptr<UnitDiskNetDevice::Reception>>&
+UnitDiskNetDevice::ActiveReceptions()
+{
+  Time now = Simulator::Now();
+  m_receptions.erase(std::remove_if(m_receptions.begin(), m_receptions.end(),
+                                    [now] (const std::shared_ptr<Reception>& reception) {
+                                      return reception->end <= now;
+                                    }),
+                     m_receptions.end());
+  return m_receptions;
+}
+
+void
+UnitDiskNetDevice::DoDispose()
+{
+  m_channel = 0;
+  m_node = 0;
+  m_queue.clear();
+  m_receptions.clear();
+  m_rxCallback.Nullify();
+  m_promiscRxCallback.Nullify();
+  NetDevice::DoDispose();
+}
+
+void
+UnitDiskNetDevice::SetIfIndex(const uint32_t index)
+{
+  m_ifIndex = index;
+}
+
+uint32_t
+UnitDiskNetDevice::GetIfIndex() const
+{
+  return m_ifIndex;
+}
+
+Ptr<Channel>
+UnitDiskNetDevice::GetChannel() const
+{
+  return m_channel;
+}
+
+void
+UnitDiskNetDevice::SetAddress(Address address)
+{
+  m_address = Mac48Address::ConvertFrom(address);
+}
+
+Address
+UnitDiskNetDevice::GetAddress() const
+{
+  return m_address;
+}
+
+bool
+UnitDiskNetDevice::SetMtu(const uint16_t mtu)
+{
+  m_mtu = mtu;
+  return true;
+}
+
+uint16_t
+UnitDiskNetDevice::GetMtu() const
+{
+  return m_mtu;
+}
+
+bool
+UnitDiskNetDevice::IsLinkUp() const
+{
+  return m_channel != 0;
+}
+
+void
+UnitDiskNetDevice::AddLinkChangeCallback(Callback<void> callback)
+{
+}
+
+bool
+UnitDiskNetDevice::IsBroadcast() const
+{
+  return true;
+}
+
+Address
+UnitDiskNetDevice::GetBroadcast() const
+{
+  return Mac48Address::GetBroadcast();
+}
+
+bool
+UnitDiskNetDevice::IsMulticast() const
+{
+  return true;
+}
+
+Address
+UnitDiskNetDevice::GetMulticast(Ipv4Address multicastGroup) const
+{
+  return Mac48Address::GetMulticast(multicastGroup);
+}
+
+Address
+UnitDiskNetDevice::GetMulticast(Ipv6Address addr) const
+{
+  return Mac48Address::GetMulticast(addr);
+}
+
+bool
+UnitDiskNetDevice::IsBridge() const
+{
+  return false;
+}
+
+bool
+UnitDiskNetDevice::IsPointToPoint() const
+{
+  return false;
+}
+
+Ptr<Node>
+UnitDiskNetDevice::GetNode() const
+{
+  return m_node;
+}
+
+void
+UnitDiskNetDevice::SetNode(Ptr<Node> node)
+{
+  m_node = node;
+}
+
+bool
+UnitDiskNetDevice::NeedsArp() const
+{
+  return false;
+}
+
+void
+UnitDiskNetDevice::SetReceiveCallback(NetDevice::ReceiveCallback cb)
+{
+  m_rxCallback = cb;
+}
+
+void
+UnitDiskNetDevice::SetPromiscReceiveCallback(NetDevice::PromiscReceiveCallback cb)
+{
+  m_promiscRxCallback = cb;
+}
+
+bool
+UnitDiskNetDevice::SupportsSendFrom() const
+{
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"google"; indent-tabs-mode:nil; -*- */
+
+#ifndef SYNC_COMMON_UNIT_DISK_NET_DEVICE_HPP_
+#define SYNC_COMMON_UNIT_DISK_NET_DEVICE_HPP_
+
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "unit-disk-channel.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief NetDevice of the unit-disk fast mode, a cheap stand-in for the
+ *        802.11 stack when only protocol-level trends matter.
+ *
+ * Frames wait in a drop-tail queue and are sent after a random backoff of
+ * [0, ContentionWindow) slots, deferring while the device hears another
+ * frame (carrier sense). A frame is lost at a receiver if it overlaps
+ * another frame heard there or a transmission of the receiver itself, or
+ * with the channel's LossProbability. Devices that pick the same slot
+ * collide. There are no acks or retransmissions, as for 802.11 broadcast.
+ */
+class UnitDiskNetDevice : public NetDevice
+{
+public:
+  static TypeId
+  GetTypeId();
+
+  UnitDiskNetDevice();
+
+  void
+  SetChannel(Ptr<UnitDiskChannel> channel);
+
+  /**
+   * @brief Use fixed random streams from @p stream on.
+   * @return Number of streams used
+   */
+  int64_t
+  AssignStreams(int64_t stream);
+
+  /**
+   * @brief Called by the channel when a frame of another device in range
+   *        starts, lasting @p duration.
+   */
+  void
+  StartReceive(Ptr<const Packet> packet, uint16_t protocol, const Address& from,
+               const Address& to, Time duration);
+
+  // inherited from NetDevice
+  virtual void
+  SetIfIndex(const uint32_t index) override;
+
+  virtual uint32_t
+  GetIfIndex() const override;
+
+  virtual Ptr<Channel>
+  GetChannel() const override;
+
+  virtual void
+  SetAddress(Address address) override;
+
+  virtual Address
+  GetAddress() const override;
+
+  virtual bool
+  SetMtu(const uint16_t mtu) override;
+
+  virtual uint16_t
+  GetMtu() const override;
+
+  virtual bool
+  IsLinkUp() const override;
+
+  virtual void
+  AddLinkChangeCallback(Callback<void> callback) override;
+
+  virtual bool
+  IsBroadcast() const override;
+
+  virtual Address
+  GetBroadcast() const override;
+
+  virtual bool
+  IsMulticast() const override;
+
+  virtual Address
+  GetMulticast(Ipv4Address multicastGroup) const override;
+
+  virtual Address
+  GetMulticast(Ipv6Address addr) const override;
+
+  virtual bool
+  IsBridge() const override;
+
+  virtual bool
+  IsPointToPoint() const override;
+
+  virtual bool
+  Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) override;
+
+  virtual bool
+  SendFrom(Ptr<Packet> packet, const Address& source, const Address& dest,
+           uint16_t protocolNumber) override;
+
+  virtual Ptr<Node>
+  GetNode() const override;
+
+  virtual void
+  SetNode(Ptr<Node> node) override;
+
+  virtual bool
+  NeedsArp() const override;
+
+  virtual void
+  SetReceiveCallback(NetDevice::ReceiveCallback cb) override;
+
+  virtual void
+  SetPromiscReceiveCallback(NetDevice::PromiscReceiveCallback cb) override;
+
+  virtual bool
+  SupportsSendFrom() const override;
+
+protected:
+  virtual void
+  DoDispose() override;
+
+private:
+  struct Frame {
+    Ptr<const Packet> packet;
+    uint16_t protocol;
+    Mac48Address from;
+    Mac48Address to;
+  };
+
+  struct Reception {
+    Frame frame;
+    Time start;
+    Time end;
+    bool collided;
+  };
+
+  /* Wait a random number of slots before trying to send the head of the queue */
+  void
+  StartBackoff();
+
+  void
+  TryTransmit();
+
+  void
+  EndTransmit();
+
+  void
+  EndReceive(std::shared_ptr<Reception> reception);
+
+  /* Frames heard now, after dropping those that ended */
+  std::vector<std::shared_ptr<Reception>>&
+  ActiveReceptions();
+
+  Ptr<UnitDiskChannel> m_channel;
+  Ptr<Node> m_node;
+  Mac48Address m_address;
+  uint32_t m_ifIndex;
+  uint16_t m_mtu;
+  uint32_t m_maxQueue;
+  Time m_slot;
+  uint32_t m_contentionWindow;
+  Ptr<UniformRandomVariable> m_random;
+
+  std::deque<Frame> m_queue;
+  bool m_sending;                 /* Backing off or transmitting the queue head */
+  Time m_txEnd;
+  std::vector<std::shared_ptr<Reception>> m_receptions;
+
+  NetDevice::ReceiveCallback m_rxCallback;
+  NetDevice::PromiscReceiveCallback m_promiscRxCallback;
+
+  TracedCallback<Ptr<const Packet>> m_dropTrace;       /* Queue full */
+  TracedCallback<Ptr<const Packet>> m_collisionTrace;  /* Lost to an overlapping frame */
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // SYNC_COMMON_UNIT_DISK_NET_DEVICE_HPP_